@@ -1,19 +1,140 @@
 #pragma once
 #include "accumulation_traits.h"
 #include "policy.h"
+#include <cstddef>
+#include <type_traits>
 
+template <typename X> constexpr bool isAssociative() {
+  if constexpr (requires { X::associative; }) {
+    return X::associative;
+  } else {
+    return false;
+  }
+}
+
+template <typename X> struct IsNoPolicy2 : std::false_type {};
+template <typename T1, typename T2>
+struct IsNoPolicy2<NoPolicy2<T1, T2>> : std::true_type {};
+
+// 分组累加、再用 Policy::combine 合并部分结果，要求两个策略合起来仍是一种
+// 可结合的运算：各自 associative，并且 Policy2 什么也不做，或者与 Policy
+// 的 Operation 相同。否则（如 MultPolicy 加 SumPolicy2）每个元素先乘后加，
+// 合并部分结果时却只相乘，结果与逐个累加不同。
+template <typename AT, typename Policy, typename Policy2>
+constexpr bool canSplitAccumulation() {
+  if constexpr (!isAssociative<AT>() || !isAssociative<Policy>() ||
+                !isAssociative<Policy2>()) {
+    return false;
+  } else if constexpr (IsNoPolicy2<Policy2>::value) {
+    return true;
+  } else if constexpr (requires {
+                         typename Policy::Operation;
+                         typename Policy2::Operation;
+                       }) {
+    return std::is_same_v<typename Policy::Operation,
+                          typename Policy2::Operation>;
+  } else {
+    return false;
+  }
+}
+
+// 特征给出的默认策略
+template <typename AT> struct AccPolicyOf {
+  using Type = SumPolicy;
+};
+template <typename AT>
+  requires requires { typename AT::Policy; }
+struct AccPolicyOf<AT> {
+  using Type = typename AT::Policy;
+};
+
+template <typename AT> struct AccPolicy2Of {
+  template <typename T1, typename T2> using Type = SumPolicy2<T1, T2>;
+};
+template <typename AT>
+  requires requires { typename AT::template Policy2<int, int>; }
+struct AccPolicy2Of<AT> {
+  template <typename T1, typename T2>
+  using Type = typename AT::template Policy2<T1, T2>;
+};
+
+// 累加的初值：策略给出的单位元，否则为累加特征的 zero()
+template <typename AT, typename Policy> constexpr auto accIdentity() {
+  using ResType = typename AT::AccT;
+  if constexpr (requires { Policy::template identity<ResType>(); }) {
+    return Policy::template identity<ResType>();
+  } else {
+    return AT::zero();
+  }
+}
+
+// 多个独立的累加器：每 Lanes 个元素分别累加到 Lanes 个 AccT 中，
+// 消除了单个累加器带来的循环依赖，编译器可以把内层循环向量化
+// （同时完成 T 到 AccT 的加宽）。累加器共占 128 字节，剩余的元素和
+// 各累加器最后合并到一起。
+template <typename T, typename AT, typename Policy, typename Policy2>
+auto accmulateLanes(T const *start, T const *end) {
+  using ResType = typename AT::AccT;
+  constexpr std::size_t Lanes =
+      sizeof(ResType) >= 32 ? 4 : 128 / sizeof(ResType);
+
+  ResType lanes[Lanes];
+  for (auto &lane : lanes) {
+    lane = accIdentity<AT, Policy>();
+  }
+  std::size_t n = std::size_t(end - start);
+  std::size_t i = 0;
+  for (; i + Lanes <= n; i += Lanes) {
+    for (std::size_t k = 0; k != Lanes; ++k) {
+      Policy::acc(lanes[k], start[i + k]);
+      Policy2::acc(lanes[k], start[i + k]);
+    }
+  }
+
+  ResType res = accIdentity<AT, Policy>();
+  for (auto const &lane : lanes) {
+    Policy::combine(res, lane);
+  }
+  for (; i != n; ++i) {
+    Policy::acc(res, start[i]);
+    Policy2::acc(res, start[i]);
+  }
+  return res;
+}
+
+// 策略提供 accRange 时一次累加整个区间；否则满足 canSplitAccumulation 时
+// 使用多累加器的版本，其余情况逐个累加。
 template <typename T, typename AT = AccumulationTraits<T>,
-          typename Policy = SumPolicy,
-          template <typename, typename> class Policy_2 = SumPolicy2>
+          typename Policy = typename AccPolicyOf<AT>::Type,
+          template <typename, typename> class Policy_2 =
+              AccPolicy2Of<AT>::template Type>
 auto accmulate(T const *start, T const *end) {
   using ResType = typename AT::AccT;
-  ResType res = AT::zero();
+  if constexpr (requires(ResType &res) { Policy::accRange(res, start, end); }) {
+    ResType res = accIdentity<AT, Policy>();
+    Policy::accRange(res, start, end);
+    if constexpr (requires(ResType &res) {
+                    Policy_2<ResType, T>::accRange(res, start, end);
+                  }) {
+      Policy_2<ResType, T>::accRange(res, start, end);
+    } else {
+      for (T const *p = start; p != end; ++p) {
+        Policy_2<ResType, T>::acc(res, *p);
+      }
+    }
+    return res;
+  } else if constexpr (canSplitAccumulation<AT, Policy,
+                                            Policy_2<ResType, T>>()) {
+    return accmulateLanes<T, AT, Policy, Policy_2<ResType, T>>(start, end);
+  } else {
+    ResType res = accIdentity<AT, Policy>();
 
-  while (start != end) {
-    // res += *start;
-    Policy::acc(res, *start); // member templates
-    Policy_2<ResType, T>::acc(res, *start);
-    ++start;
+    while (start != end) {
+      // res += *start;
+      Policy::acc(res, *start); // member templates
+      Policy_2<ResType, T>::acc(res, *start);
+      ++start;
+    }
+    return res;
   }
-  return res;
 }
@@ -0,0 +1,192 @@
+// accmulate 的吞吐量：分别对 256 KB（在缓存中）和 64 MB 的数组求和，比较
+// 单个累加器的逐个累加（策略不声明 associative）与多累加器版本，输出每秒
+// 处理的字节数。64 MB 时再加上使用全部硬件线程的 parallelAccumulate。
+// 然后比较 float 的几种求和方式的吞吐量和相对于 long double 的相对误差。
+// 最后是 long 在 BigInt 中的精确累加，以及 BigInt 乘法随长度增长的耗时。
+#include "parallel_acc.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 与 SumPolicy 相同，但不声明 associative，accmulate 只能逐个累加
+class SerialSumPolicy {
+public:
+  template <typename T1, typename T2>
+  static void acc(T1 &total, T2 const &right) {
+    total += right;
+  }
+};
+
+// 不内联，使长度在编译期未知，与实际调用的情况一致
+template <typename T>
+[[gnu::noinline]] auto accmulateSerial(T const *begin, T const *end) {
+  return accmulate<T, AccumulationTraits<T>, SerialSumPolicy>(begin, end);
+}
+template <typename T>
+[[gnu::noinline]] auto accmulateLanes(T const *begin, T const *end) {
+  return accmulate(begin, end);
+}
+
+template <typename T>
+void run(char const *name, std::size_t Bytes, int rounds) {
+  std::vector<T> data(Bytes / sizeof(T));
+  for (std::size_t i = 0; i != data.size(); ++i) {
+    data[i] = T(i % 100);
+  }
+  T const *begin = data.data();
+  T const *end = begin + data.size();
+
+  auto measure = [&](auto f) {
+    auto best = std::chrono::duration<double>::max();
+    decltype(f()) result{};
+    for (int round = 0; round != rounds; ++round) {
+      auto start = std::chrono::steady_clock::now();
+      result = f();
+      best = std::min(best, std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start));
+    }
+    return std::pair(result, double(Bytes) / best.count() / 1e9);
+  };
+  auto [serial, serialRate] =
+      measure([&] { return accmulateSerial(begin, end); });
+  auto [lanes, lanesRate] = measure([&] { return accmulateLanes(begin, end); });
+  std::printf("%-6s %5zu KB  serial %6.2f GB/s  lanes %6.2f GB/s", name,
+              Bytes >> 10, serialRate, lanesRate);
+  if (Bytes >= (std::size_t(1) << 20)) {
+    auto [parallel, parallelRate] =
+        measure([&] { return parallelAccumulate(begin, end); });
+    // 浮点的并行结果按块合并，和串行的舍入不同，只比较整数
+    bool same = std::is_integral_v<T> ? parallel == lanes : true;
+    std::printf("  parallel %6.2f GB/s%s", parallelRate,
+                same ? "" : " DIFFERENT");
+  }
+  std::printf("  %s\n", serial == lanes ? "equal" : "DIFFERENT");
+}
+
+// 在 Acc 中直接求和（多累加器），只用 SumPolicy 累加一次
+template <typename Acc> struct PlainAccumulationTraits {
+  using AccT = Acc;
+  static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
+  template <typename T1, typename T2> using Policy2 = NoPolicy2<T1, T2>;
+};
+
+template <typename AT>
+[[gnu::noinline]] float accmulateFloat(float const *begin, float const *end) {
+  return float(accmulate<float, AT>(begin, end));
+}
+
+void runFloat(std::size_t Bytes, int rounds) {
+  std::vector<float> data(Bytes / sizeof(float));
+  long double exact = 0;
+  for (std::size_t i = 0; i != data.size(); ++i) {
+    data[i] = 1.0f / float(i % 10007 + 1);
+    exact += data[i];
+  }
+  float const *begin = data.data();
+  float const *end = begin + data.size();
+
+  auto report = [&](char const *name, auto f) {
+    auto best = std::chrono::duration<double>::max();
+    float result = 0;
+    for (int round = 0; round != rounds; ++round) {
+      auto start = std::chrono::steady_clock::now();
+      result = f(begin, end);
+      best = std::min(best, std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start));
+    }
+    std::printf("  %-9s %6.2f GB/s  error %.2Le\n", name,
+                double(Bytes) / best.count() / 1e9,
+                std::abs((result - exact) / exact));
+  };
+  std::printf("float sum %zu KB\n", Bytes >> 10);
+  report("float", accmulateFloat<PlainAccumulationTraits<float>>);
+  report("double", accmulateFloat<PlainAccumulationTraits<double>>);
+  report("kahan", accmulateFloat<KahanAccumulationTraits<float>>);
+  report("pairwise", accmulateFloat<PairwiseAccumulationTraits<float>>);
+}
+
+[[gnu::noinline]] BigInt accmulateBig(long const *begin, long const *end) {
+  return accmulate<long, AccumulationTraits<long>, SumPolicy, NoPolicy2>(begin,
+                                                                         end);
+}
+[[gnu::noinline]] __int128 accmulateInt128(long const *begin,
+                                           long const *end) {
+  __int128 total = 0;
+  for (; begin != end; ++begin) {
+    total += *begin;
+  }
+  return total;
+}
+
+volatile bool sink; // 使结果不被优化掉
+
+void runBigInt(std::size_t Bytes, int rounds) {
+  std::vector<long> data(Bytes / sizeof(long));
+  for (std::size_t i = 0; i != data.size(); ++i) {
+    data[i] = long(i * 0x9e3779b97f4a7c15ull) >> 1;
+  }
+  long const *begin = data.data();
+  long const *end = begin + data.size();
+  auto rate = [&](auto f) {
+    auto best = std::chrono::duration<double>::max();
+    for (int round = 0; round != rounds; ++round) {
+      auto start = std::chrono::steady_clock::now();
+      sink = f(begin, end) != 0;
+      best = std::min(best, std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start));
+    }
+    return double(Bytes) / best.count() / 1e9;
+  };
+  std::printf("long   %5zu KB  bigint %6.2f GB/s  int128 %6.2f GB/s  %s\n",
+              Bytes >> 10, rate(accmulateBig), rate(accmulateInt128),
+              accmulateBig(begin, end) ==
+                      BigInt(long(accmulateInt128(begin, end) >> 64)) *
+                              BigInt(std::uint64_t(1) << 32) *
+                              BigInt(std::uint64_t(1) << 32) +
+                          BigInt(std::uint64_t(accmulateInt128(begin, end)))
+                  ? "equal"
+                  : "DIFFERENT");
+}
+
+// n 个 limb 的两个数相乘的耗时
+void runBigIntMultiply(std::size_t n) {
+  BigInt a = 1, b = 1;
+  for (std::size_t i = 0; i != n; ++i) {
+    a = a * BigInt(0xfedcba9876543210ull) + BigInt(i);
+    b = b * BigInt(0x0123456789abcdefull) + BigInt(i);
+  }
+  int rounds = int(std::max<std::size_t>(1, (1 << 22) / (n * n)));
+  auto best = std::chrono::duration<double>::max();
+  std::size_t limbs = 0;
+  for (int round = 0; round != rounds; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    limbs = (a * b).limbCount();
+    best = std::min(best, std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start));
+  }
+  std::printf("bigint multiply %5zu limbs  %10.2f us  (%zu limbs)\n", n,
+              best.count() * 1e6, limbs);
+}
+
+int main() {
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  for (auto [bytes, rounds] : {std::pair(std::size_t(256) << 10, 2000),
+                                std::pair(std::size_t(64) << 20, 5)}) {
+    run<char>("char", bytes, rounds);
+    run<short>("short", bytes, rounds);
+    run<int>("int", bytes, rounds);
+    run<float>("float", bytes, rounds);
+  }
+  runFloat(std::size_t(256) << 10, 2000);
+  runFloat(std::size_t(64) << 20, 5);
+  runBigInt(std::size_t(256) << 10, 200);
+  runBigInt(std::size_t(64) << 20, 3);
+  for (std::size_t n : {16, 32, 64, 256, 1024, 4096}) {
+    runBigIntMultiply(n);
+  }
+}
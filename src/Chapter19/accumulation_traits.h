@@ -1,31 +1,70 @@
-class BigInt;
+#pragma once
+#include "big_int.h"
+#include "policy.h"
 
 template <typename T> struct AccumulationTraits;
 
+// associative 表示在 AccT 中累加的结果与元素的顺序无关，
+// accmulate 据此把元素分给多个独立的累加器并行累加
 template <> struct AccumulationTraits<char> {
   using AccT = int;
   static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
 };
 template <> struct AccumulationTraits<short> {
   using AccT = int;
   static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
 };
 template <> struct AccumulationTraits<int> {
   using AccT = long;
   static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
 };
 template <> struct AccumulationTraits<unsigned int> {
   using AccT = unsigned long;
   static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
 };
+// 浮点加法严格来说不满足结合律，但 float 在 double 中累加时，
+// 调整顺序带来的误差远小于 float 本身的精度
 template <> struct AccumulationTraits<float> {
   using AccT = double;
   static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
 };
 
+// 不把 float 提升为 double，而是在 float 中用补偿求和或两两求和保证精度。
+// 特征还给出默认的策略：accmulate 的 Policy 默认为 AT::Policy，
+// Policy_2 默认为 AT::Policy2（没有给出时分别为 SumPolicy 和 SumPolicy2）。
+template <typename T> struct KahanAccumulationTraits;
+template <> struct KahanAccumulationTraits<float> {
+  using AccT = KahanSum<float>;
+  static constexpr AccT zero() { return {}; }
+  static constexpr bool associative = true;
+  using Policy = KahanSumPolicy;
+  template <typename T1, typename T2> using Policy2 = NoPolicy2<T1, T2>;
+};
+
+template <typename T> struct PairwiseAccumulationTraits;
+template <> struct PairwiseAccumulationTraits<float> {
+  using AccT = float;
+  static constexpr AccT zero() { return 0; }
+  static constexpr bool associative = true;
+  using Policy = PairwiseSumPolicy;
+  template <typename T1, typename T2> using Policy2 = NoPolicy2<T1, T2>;
+};
+
+// long 的和可能超出 long 的范围，在 BigInt 中精确累加
+template <> struct AccumulationTraits<long> {
+  using AccT = BigInt;
+  static BigInt zero() { return BigInt{0}; }
+  static constexpr bool associative = true;
+};
 template <> struct AccumulationTraits<BigInt> {
   using AccT = BigInt;
-  // static BigInt zero() { return BigInt{0}; }
+  static BigInt zero() { return BigInt{0}; }
+  static constexpr bool associative = true;
 };
 
 // 针对 zero，对于 literal type，可以直接使用 static const int/enum 或 static
@@ -0,0 +1,486 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// 任意精度整数
+// 以符号和绝对值表示，绝对值按 64 位的 limb 从低到高存放，最高的 limb
+// 不为 0（0 没有 limb）。不超过 InlineLimbs 个 limb 时存放在对象内部，
+// 不分配内存。+= 和 -= 在原地完成，容量足够时不会重新分配，可以直接作为
+// 累加器；预先 reserve 就能保证整个累加过程不分配内存。
+// 乘法在较短的操作数不少于 KaratsubaThreshold 个 limb 时使用 Karatsuba 算法。
+// 乘除 limb 使用 GCC / Clang 的 unsigned __int128。
+class BigInt {
+public:
+  using Limb = std::uint64_t;
+
+private:
+  using DoubleLimb = unsigned __int128;
+  static constexpr std::uint32_t InlineLimbs = 2;
+  static constexpr std::size_t KaratsubaThreshold = 32;
+
+  union Storage {
+    Limb local[InlineLimbs];
+    Limb *heap;
+  };
+  Storage storage = {};
+  std::uint32_t count = 0;                  // 使用的 limb 数
+  std::uint32_t capacity = InlineLimbs;     // 可用的 limb 数
+  bool negative = false;
+
+  bool onHeap() const { return capacity > InlineLimbs; }
+  Limb *limbs() { return onHeap() ? storage.heap : storage.local; }
+  Limb const *limbs() const { return onHeap() ? storage.heap : storage.local; }
+
+  // 带进位的加法和带借位的减法，x86-64 下使用 adc / sbb
+  static unsigned char addCarry(unsigned char carry, Limb a, Limb b,
+                                Limb &out) {
+#if defined(__x86_64__)
+    unsigned long long sum;
+    carry = _addcarry_u64(carry, a, b, &sum);
+    out = sum;
+    return carry;
+#else
+    Limb sum = a + b;
+    unsigned char high = sum < a;
+    out = sum + carry;
+    return high | (out < sum);
+#endif
+  }
+  static unsigned char subBorrow(unsigned char borrow, Limb a, Limb b,
+                                 Limb &out) {
+#if defined(__x86_64__)
+    unsigned long long difference;
+    borrow = _subborrow_u64(borrow, a, b, &difference);
+    out = difference;
+    return borrow;
+#else
+    Limb difference = a - b;
+    unsigned char high = a < b;
+    out = difference - borrow;
+    return high | (difference < Limb(borrow));
+#endif
+  }
+
+  // r[0, rn) += a[0, an)，an <= rn，返回最高位的进位
+  static unsigned char addInto(Limb *r, std::size_t rn, Limb const *a,
+                               std::size_t an) {
+    unsigned char carry = 0;
+    std::size_t i = 0;
+    for (; i != an; ++i) {
+      carry = addCarry(carry, r[i], a[i], r[i]);
+    }
+    for (; carry && i != rn; ++i) {
+      carry = addCarry(carry, r[i], 0, r[i]);
+    }
+    return carry;
+  }
+  // r[0, rn) -= a[0, an)，an <= rn，返回最高位的借位
+  static unsigned char subInto(Limb *r, std::size_t rn, Limb const *a,
+                               std::size_t an) {
+    unsigned char borrow = 0;
+    std::size_t i = 0;
+    for (; i != an; ++i) {
+      borrow = subBorrow(borrow, r[i], a[i], r[i]);
+    }
+    for (; borrow && i != rn; ++i) {
+      borrow = subBorrow(borrow, r[i], 0, r[i]);
+    }
+    return borrow;
+  }
+
+  static std::strong_ordering compareMagnitude(Limb const *a, std::size_t an,
+                                               Limb const *b, std::size_t bn) {
+    if (an != bn) {
+      return an <=> bn;
+    }
+    for (std::size_t i = an; i != 0; --i) {
+      if (a[i - 1] != b[i - 1]) {
+        return a[i - 1] <=> b[i - 1];
+      }
+    }
+    return std::strong_ordering::equal;
+  }
+
+  // 以下的乘法都要求 r 有 an + bn 个 limb 且已清零
+  static void mulSchoolbook(Limb *r, Limb const *a, std::size_t an,
+                            Limb const *b, std::size_t bn) {
+    for (std::size_t i = 0; i != an; ++i) {
+      Limb carry = 0;
+      for (std::size_t j = 0; j != bn; ++j) {
+        DoubleLimb t = DoubleLimb(a[i]) * b[j] + r[i + j] + carry;
+        r[i + j] = Limb(t);
+        carry = Limb(t >> 64);
+      }
+      r[i + bn] = carry;
+    }
+  }
+
+  // a、b 都有 n 个 limb：a = a1 * B^h + a0，b = b1 * B^h + b0，
+  // a * b = z2 * B^2h + (z1 - z2 - z0) * B^h + z0，
+  // 其中 z0 = a0 * b0，z2 = a1 * b1，z1 = (a0 + a1) * (b0 + b1)
+  static void mulKaratsuba(Limb *r, Limb const *a, Limb const *b,
+                           std::size_t n) {
+    std::size_t h = n / 2;
+    std::size_t hh = n - h;
+    mulMagnitude(r, a, h, b, h);
+    mulMagnitude(r + 2 * h, a + h, hh, b + h, hh);
+
+    std::vector<Limb> sa(a + h, a + n), sb(b + h, b + n);
+    sa.push_back(addInto(sa.data(), hh, a, h));
+    sb.push_back(addInto(sb.data(), hh, b, h));
+    std::vector<Limb> z1(2 * hh + 2);
+    mulMagnitude(z1.data(), sa.data(), hh + 1, sb.data(), hh + 1);
+    subInto(z1.data(), z1.size(), r, 2 * h);
+    subInto(z1.data(), z1.size(), r + 2 * h, 2 * hh);
+    // z1 - z2 - z0 = a0 * b1 + a1 * b0 < B^(n + 1)，高出的 limb 都是 0
+    std::size_t used = std::min(z1.size(), n + 1);
+    addInto(r + h, 2 * n - h, z1.data(), used);
+  }
+
+  static void mulMagnitude(Limb *r, Limb const *a, std::size_t an,
+                           Limb const *b, std::size_t bn) {
+    if (an < bn) {
+      std::swap(a, b);
+      std::swap(an, bn);
+    }
+    if (bn < KaratsubaThreshold) {
+      mulSchoolbook(r, a, an, b, bn);
+    } else if (an == bn) {
+      mulKaratsuba(r, a, b, bn);
+    } else {
+      // 长短不一时把较长的一方按较短的长度分段，每段都是平衡的乘法
+      std::vector<Limb> part(2 * bn);
+      for (std::size_t i = 0; i < an; i += bn) {
+        std::size_t length = std::min(bn, an - i);
+        std::fill(part.begin(), part.end(), 0);
+        mulMagnitude(part.data(), a + i, length, b, bn);
+        addInto(r + i, an + bn - i, part.data(), length + bn);
+      }
+    }
+  }
+
+  void trim() {
+    Limb const *p = limbs();
+    while (count != 0 && p[count - 1] == 0) {
+      --count;
+    }
+    negative = negative && count != 0;
+  }
+
+  // 累加内置整数时的快速路径：*this 非 0，加上一个带符号的 limb
+  BigInt &addLimb(Limb b, bool bNegative) {
+    Limb *a = limbs();
+    std::size_t i = 1;
+    if (negative == bNegative) {
+      unsigned char carry = addCarry(0, a[0], b, a[0]);
+      for (; carry && i != count; ++i) {
+        carry = addCarry(carry, a[i], 0, a[i]);
+      }
+      if (carry) {
+        reserve(count + 1);
+        limbs()[count++] = 1;
+      }
+    } else if (count > 1 || a[0] >= b) {
+      unsigned char borrow = subBorrow(0, a[0], b, a[0]);
+      for (; borrow && i != count; ++i) {
+        borrow = subBorrow(borrow, a[i], 0, a[i]);
+      }
+      trim();
+    } else {
+      a[0] = b - a[0];
+      negative = bNegative;
+    }
+    return *this;
+  }
+
+  // *this += (bNegative ? -1 : 1) * b[0, bn)，b 不能指向自身的 limb
+  BigInt &addSigned(Limb const *b, std::size_t bn, bool bNegative) {
+    if (bn == 0) {
+      return *this;
+    }
+    if (count == 0 || negative == bNegative) {
+      // 在原地相加，只有进位超出最高的 limb 时才增长（与 addLimb 相同）
+      std::size_t n = std::max<std::size_t>(count, bn);
+      reserve(n);
+      Limb *a = limbs();
+      std::fill(a + count, a + n, 0);
+      unsigned char carry = addInto(a, n, b, bn);
+      count = std::uint32_t(n);
+      negative = bNegative;
+      if (carry) {
+        reserve(count + 1);
+        limbs()[count++] = 1;
+      }
+    } else if (compareMagnitude(limbs(), count, b, bn) >= 0) {
+      subInto(limbs(), count, b, bn);
+      trim();
+    } else {
+      // |*this| < |b|：结果为 b - |*this|，符号取 b 的
+      reserve(bn);
+      Limb *a = limbs();
+      unsigned char borrow = 0;
+      for (std::size_t i = 0; i != bn; ++i) {
+        borrow = subBorrow(borrow, b[i], i < count ? a[i] : 0, a[i]);
+      }
+      count = std::uint32_t(bn);
+      negative = bNegative;
+      trim();
+    }
+    return *this;
+  }
+
+  template <std::integral I>
+  static std::pair<Limb, bool> magnitudeOf(I value) {
+    if constexpr (std::is_signed_v<I>) {
+      if (value < 0) {
+        return {Limb(0) - Limb(value), true};
+      }
+    }
+    return {Limb(value), false};
+  }
+
+public:
+  BigInt() = default;
+  template <std::integral I>
+    requires(sizeof(I) <= sizeof(Limb))
+  BigInt(I value) {
+    auto [magnitude, isNegative] = magnitudeOf(value);
+    storage.local[0] = magnitude;
+    count = magnitude != 0;
+    negative = isNegative;
+  }
+  BigInt(BigInt const &other) { *this = other; }
+  BigInt(BigInt &&other) noexcept { swap(other); }
+  ~BigInt() {
+    if (onHeap()) {
+      delete[] storage.heap;
+    }
+  }
+
+  // 容量足够时复用已有的内存
+  BigInt &operator=(BigInt const &other) {
+    if (this != &other) {
+      count = 0;
+      reserve(other.count);
+      std::copy_n(other.limbs(), other.count, limbs());
+      count = other.count;
+      negative = other.negative;
+    }
+    return *this;
+  }
+  BigInt &operator=(BigInt &&other) noexcept {
+    BigInt moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  void swap(BigInt &other) noexcept {
+    std::swap(storage, other.storage);
+    std::swap(count, other.count);
+    std::swap(capacity, other.capacity);
+    std::swap(negative, other.negative);
+  }
+
+  // 预留至少 n 个 limb 的空间
+  void reserve(std::size_t n) {
+    if (n <= capacity) {
+      return;
+    }
+    std::size_t grown = std::max<std::size_t>(n, 2 * std::size_t(capacity));
+    Limb *p = new Limb[grown];
+    std::copy_n(limbs(), count, p);
+    if (onHeap()) {
+      delete[] storage.heap;
+    }
+    storage.heap = p;
+    capacity = std::uint32_t(grown);
+  }
+
+  std::size_t limbCount() const { return count; }
+  std::size_t limbCapacity() const { return capacity; }
+  bool isNegative() const { return negative; }
+
+  BigInt &operator+=(BigInt const &other) {
+    if (this == &other) {
+      return *this += BigInt(other);
+    }
+    return addSigned(other.limbs(), other.count, other.negative);
+  }
+  BigInt &operator-=(BigInt const &other) {
+    if (this == &other) {
+      count = 0;
+      negative = false;
+      return *this;
+    }
+    return addSigned(other.limbs(), other.count, !other.negative);
+  }
+  // 与内置整数的运算不构造临时的 BigInt
+  template <std::integral I>
+    requires(sizeof(I) <= sizeof(Limb))
+  BigInt &operator+=(I value) {
+    auto [magnitude, isNegative] = magnitudeOf(value);
+    if (count != 0 && magnitude != 0) {
+      return addLimb(magnitude, isNegative);
+    }
+    return addSigned(&magnitude, magnitude != 0, isNegative);
+  }
+  template <std::integral I>
+    requires(sizeof(I) <= sizeof(Limb))
+  BigInt &operator-=(I value) {
+    auto [magnitude, isNegative] = magnitudeOf(value);
+    if (count != 0 && magnitude != 0) {
+      return addLimb(magnitude, !isNegative);
+    }
+    return addSigned(&magnitude, magnitude != 0, !isNegative);
+  }
+  BigInt &operator*=(BigInt const &other) { return *this = *this * other; }
+
+  BigInt operator-() const {
+    BigInt result(*this);
+    result.negative = count != 0 && !negative;
+    return result;
+  }
+
+  friend BigInt operator+(BigInt a, BigInt const &b) { return a += b; }
+  friend BigInt operator-(BigInt a, BigInt const &b) { return a -= b; }
+  friend BigInt operator*(BigInt const &a, BigInt const &b) {
+    BigInt result;
+    if (a.count == 0 || b.count == 0) {
+      return result;
+    }
+    std::size_t n = std::size_t(a.count) + b.count;
+    result.reserve(n);
+    std::fill_n(result.limbs(), n, 0);
+    mulMagnitude(result.limbs(), a.limbs(), a.count, b.limbs(), b.count);
+    result.count = std::uint32_t(n);
+    result.negative = a.negative != b.negative;
+    result.trim();
+    return result;
+  }
+
+  friend bool operator==(BigInt const &a, BigInt const &b) {
+    return a.negative == b.negative &&
+           compareMagnitude(a.limbs(), a.count, b.limbs(), b.count) == 0;
+  }
+  friend std::strong_ordering operator<=>(BigInt const &a, BigInt const &b) {
+    if (a.negative != b.negative) {
+      return a.negative ? std::strong_ordering::less
+                        : std::strong_ordering::greater;
+    }
+    auto order = compareMagnitude(a.limbs(), a.count, b.limbs(), b.count);
+    return a.negative ? 0 <=> order : order;
+  }
+
+  // 十进制表示：反复除以 10^19，每次得到 19 位
+  std::string toString() const {
+    if (count == 0) {
+      return "0";
+    }
+    constexpr Limb Chunk = 10000000000000000000ull;
+    std::vector<Limb> rest(limbs(), limbs() + count);
+    std::vector<Limb> chunks;
+    while (!rest.empty()) {
+      DoubleLimb remainder = 0;
+      for (std::size_t i = rest.size(); i != 0; --i) {
+        DoubleLimb current = (remainder << 64) | rest[i - 1];
+        rest[i - 1] = Limb(current / Chunk);
+        remainder = current % Chunk;
+      }
+      chunks.push_back(Limb(remainder));
+      while (!rest.empty() && rest.back() == 0) {
+        rest.pop_back();
+      }
+    }
+    std::string result = negative ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i != 0; --i) {
+      std::string digits = std::to_string(chunks[i - 1]);
+      result.append(19 - digits.size(), '0');
+      result += digits;
+    }
+    return result;
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, BigInt const &value) {
+    return os << value.toString();
+  }
+};
+
+void test_big_int() {
+  long const big = 0x7fffffffffffffffl;
+  BigInt sum = big;
+  sum += big;
+  assert(sum.toString() == "18446744073709551614");
+  sum -= BigInt(big) * 3;
+  assert(sum == -BigInt(big) && sum.toString() == "-9223372036854775807");
+  sum += big;
+  assert(sum == 0 && !sum.isNegative() && sum.limbCount() == 0);
+  assert(BigInt(-3) < BigInt(2) && BigInt(-3) < BigInt(-2) &&
+         BigInt(1) - BigInt(5) == -4);
+  assert((BigInt(0xffffffffffffffffull) += 1).toString() ==
+         "18446744073709551616");
+
+  // 结果仍然放得下时，两个 limb 的相加留在对象内部
+  BigInt twoLimbs = BigInt(0xffffffffffffffffull) + 1;
+  twoLimbs += twoLimbs + 5;
+  assert(twoLimbs.limbCount() == 2 && twoLimbs.limbCapacity() == 2 &&
+         twoLimbs.toString() == "36893488147419103237");
+  BigInt carried = BigInt(0xffffffffffffffffull) * BigInt(0xffffffffffffffffull);
+  carried += BigInt(0xffffffffffffffffull) * 2 + 1; // 2^128
+  assert(carried.limbCount() == 3 &&
+         carried.toString() == "340282366920938463463374607431768211456");
+
+  // 10^760 有 40 个 limb，平方和与 10^1900 的乘积都会走 Karatsuba
+  BigInt e19 = 10000000000000000000ull;
+  BigInt e760 = 1;
+  for (int i = 0; i != 40; ++i) {
+    e760 *= e19;
+  }
+  assert(e760.limbCount() >= 32);
+  BigInt e1900 = e760 * e760 * e19 * e19 * e19 * e19 * e19 * e19 * e19 *
+                 e19 * e19 * e19 * e19 * e19 * e19 * e19 * e19 * e19 * e19 *
+                 e19 * e19 * e19;
+  assert((e760 * e760).toString() == "1" + std::string(1520, '0'));
+  assert((e1900 * e760).toString() == "1" + std::string(2660, '0'));
+  assert((e1900 * -e760) == -(e760 * e1900));
+
+  // 分配律：a * (b + c) == a * b + a * c，覆盖各种长短组合
+  std::uint64_t state = 88172645463325252ull;
+  auto random = [&](std::size_t limbCount) {
+    BigInt value;
+    for (std::size_t i = 0; i != limbCount; ++i) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      value *= BigInt(std::uint64_t(1) << 32);
+      value *= BigInt(std::uint64_t(1) << 32);
+      value += state;
+    }
+    return value;
+  };
+  for (std::size_t n : {1, 31, 32, 33, 70, 150}) {
+    BigInt a = random(n), b = random(n + n / 3), c = -random(n / 2 + 1);
+    assert(a * (b + c) == a * b + a * c);
+    assert((a + b) * (a + b) - (a - b) * (a - b) == BigInt(4) * a * b);
+  }
+
+  // 累加到预留了空间的 BigInt，每次 += 都在原地完成
+  BigInt total;
+  total.reserve(4);
+  for (int i = 0; i != 1000; ++i) {
+    total += big;
+  }
+  assert(total == BigInt(big) * 1000);
+  std::cout << total << '\n';
+}
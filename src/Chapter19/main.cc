@@ -1,11 +1,16 @@
 #include "SFINAE/SFINAE.h"
 #include "acc_sum.h"
+#include "big_int.h"
 #include "named_template_args.h"
+#include "parallel_acc.h"
+#include <cmath>
 #include <iostream>
+#include <numeric>
 
 #include <iostream>
 #include <type_traits>
 #include <typeinfo>
+#include <vector>
 
 template <typename T> void f(T) {}
 template <typename A> void printParameterType(void (*)(A)) {
@@ -29,6 +34,78 @@ private:
 int main() {
   int arr[5] = {1, 2, 3, 4, 5};
   std::cout << accmulate(arr, arr + 5) << std::endl;
+  std::cout << accmulate<int, AccumulationTraits<int>, MultPolicy, NoPolicy2>(
+                   arr, arr + 5)
+            << std::endl;
+
+  // 两个策略的运算不同时不能分组累加，必须与逐个累加的结果一致
+  static_assert(!canSplitAccumulation<AccumulationTraits<int>, MultPolicy,
+                                      SumPolicy2<long, int>>());
+  static_assert(canSplitAccumulation<AccumulationTraits<int>, SumPolicy,
+                                     SumPolicy2<long, int>>());
+  std::vector<int> small(40);
+  for (std::size_t i = 0; i != small.size(); ++i) {
+    small[i] = int(i % 3) + 1;
+  }
+  long product = 1, doubled = 0;
+  for (int x : small) {
+    MultPolicy::acc(product, x);
+    SumPolicy2<long, int>::acc(product, x);
+    doubled += 2 * x;
+  }
+  int const *sb = small.data();
+  int const *se = sb + small.size();
+  std::cout << (accmulate<int, AccumulationTraits<int>, MultPolicy>(sb, se) ==
+                product)
+            << (accmulate(sb, se) == doubled) << std::endl;
+
+  // 并行累加：整数结果与串行相同，浮点结果与线程池的线程数无关
+  ThreadPool pool1(1), pool3(3), pool8(8);
+  std::vector<float> floats(1000003);
+  std::vector<int> ints(floats.size());
+  for (std::size_t i = 0; i != floats.size(); ++i) {
+    floats[i] = 1.0f / float(i + 1);
+    ints[i] = int(i % 1000) - 500;
+  }
+  float const *fb = floats.data();
+  float const *fe = fb + floats.size();
+  std::cout << (parallelAccumulate(ints.data(), ints.data() + ints.size()) ==
+                accmulate(ints.data(), ints.data() + ints.size()))
+            << (parallelAccumulate(fb, fe, pool1) ==
+                parallelAccumulate(fb, fe, pool3))
+            << (parallelAccumulate(fb, fe, pool3) ==
+                parallelAccumulate(fb, fe, pool8))
+            << std::endl;
+
+  // 在 float 中补偿求和或两两求和，误差远小于逐个累加到 float
+  long double exact = 0;
+  for (float x : floats) {
+    exact += x;
+  }
+  auto error = [&](float sum) { return std::abs(sum - exact); };
+  float naive = std::accumulate(fb, fe, 0.0f);
+  float kahan = accmulate<float, KahanAccumulationTraits<float>>(fb, fe);
+  float pairwise = accmulate<float, PairwiseAccumulationTraits<float>>(fb, fe);
+  std::cout << (error(kahan) * 100 < error(naive))
+            << (error(pairwise) * 100 < error(naive))
+            << (float(parallelAccumulate<float, KahanAccumulationTraits<float>>(
+                    fb, fe, pool1)) ==
+                float(parallelAccumulate<float, KahanAccumulationTraits<float>>(
+                    fb, fe, pool3)))
+            << std::endl;
+
+  // long 的和超出 long 的范围时，在 BigInt 中精确累加
+  test_big_int();
+  std::vector<long> amounts(100000, 0x7fffffffffffffffl / 1000);
+  long const *lb = amounts.data();
+  long const *le = lb + amounts.size();
+  BigInt exactSum =
+      accmulate<long, AccumulationTraits<long>, SumPolicy, NoPolicy2>(lb, le);
+  std::cout << exactSum << ' '
+            << (exactSum == BigInt(amounts[0]) * long(amounts.size()))
+            << (parallelAccumulate<long, AccumulationTraits<long>, SumPolicy,
+                                   NoPolicy2>(lb, le, pool3) == exactSum)
+            << std::endl;
 
   BreadSlicer_sec<Policy3_is<CustomPolicy>>::execute();
 
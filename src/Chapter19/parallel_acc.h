@@ -0,0 +1,57 @@
+#pragma once
+#include "../Chapter22/function_ptr/thread_pool.h"
+#include "acc_sum.h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+// 并行累加
+// 把区间切成固定长度的块，每块是 Chapter22 线程池上的一个任务（调用线程也
+// 参与执行），各块用 accmulate 累加，部分结果按块的顺序用 Policy::combine
+// 合并。块的划分与线程数无关，合并顺序也固定，因此同一输入无论线程池有几个
+// 线程、哪个线程处理哪一块，浮点结果都完全相同。
+// 按顺序合并只要求结合律，不要求交换律；累加特征和两个策略必须满足
+// canSplitAccumulation，即各自 associative 且合起来只做一种运算。
+// 块中抛出的异常在所有块结束后重新抛出（第一个）。
+constexpr std::size_t ParallelAccChunk = std::size_t(1) << 16;
+
+template <typename T, typename AT = AccumulationTraits<T>,
+          typename Policy = typename AccPolicyOf<AT>::Type,
+          template <typename, typename> class Policy_2 =
+              AccPolicy2Of<AT>::template Type>
+auto parallelAccumulate(T const *start, T const *end,
+                        ThreadPool &pool = ThreadPool::shared()) {
+  using ResType = typename AT::AccT;
+  static_assert(canSplitAccumulation<AT, Policy, Policy_2<ResType, T>>(),
+                "parallel accumulation requires associative traits and "
+                "policies that combine with the same operation");
+
+  std::size_t n = std::size_t(end - start);
+  std::size_t chunks = (n + ParallelAccChunk - 1) / ParallelAccChunk;
+  std::vector<ResType> partials(chunks, accIdentity<AT, Policy>());
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  pool.parallelFor(0, chunks, 1, [&](std::size_t c) {
+    T const *begin = start + c * ParallelAccChunk;
+    T const *stop = begin + std::min(ParallelAccChunk, n - c * ParallelAccChunk);
+    try {
+      partials[c] = accmulate<T, AT, Policy, Policy_2>(begin, stop);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  ResType res = accIdentity<AT, Policy>();
+  for (auto const &partial : partials) {
+    Policy::combine(res, partial);
+  }
+  return res;
+}
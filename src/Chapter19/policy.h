@@ -1,15 +1,164 @@
 #pragma once
+#include <cstddef>
+
+// 策略合并部分结果时所做的运算
+struct SumOperation {};
+struct ProductOperation {};
 
 // member template
+// associative 的策略还需提供 combine，把另一个累加器的部分结果并入 total，
+// 并用 Operation 标明 combine 做的是哪种运算：两个策略同时使用时，只有运算
+// 相同（或第二个策略是 NoPolicy2）才能分组累加后再合并。
+// 策略可以用 identity<T>() 给出单位元，否则以累加特征的 zero() 作为初值；
+// 还可以用 accRange(total, begin, end) 一次累加整个区间，accmulate 会优先
+// 使用它。
 class SumPolicy {
 public:
+  static constexpr bool associative = true;
+  using Operation = SumOperation;
   template <typename T1, typename T2>
   static void acc(T1 &total, T2 const &right) {
     total += right;
   }
+  template <typename T1> static void combine(T1 &total, T1 const &partial) {
+    total += partial;
+  }
 };
 
 template <typename T1, typename T2> class SumPolicy2 {
 public:
+  static constexpr bool associative = true;
+  using Operation = SumOperation;
   static void acc(T1 &total, T2 const &right) { total += right; }
-};
\ No newline at end of file
+  static void combine(T1 &total, T1 const &partial) { total += partial; }
+};
+
+class MultPolicy {
+public:
+  static constexpr bool associative = true;
+  using Operation = ProductOperation;
+  template <typename T> static constexpr T identity() { return T(1); }
+  template <typename T1, typename T2>
+  static void acc(T1 &total, T2 const &right) {
+    total *= right;
+  }
+  template <typename T1> static void combine(T1 &total, T1 const &partial) {
+    total *= partial;
+  }
+};
+
+// 不做任何操作，用于只需要一个策略的场合
+template <typename T1, typename T2> class NoPolicy2 {
+public:
+  static constexpr bool associative = true;
+  static void acc(T1 &, T2 const &) {}
+  static void combine(T1 &, T1 const &) {}
+};
+
+// 补偿求和（Kahan）的累加状态：compensation 记录 sum 中丢失的低位
+template <typename T> struct KahanSum {
+  T sum = 0;
+  T compensation = 0;
+
+  constexpr void add(T value) {
+    T y = value - compensation;
+    T t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+  }
+  constexpr operator T() const { return sum; }
+};
+
+// 逐个累加时是普通的 Kahan 求和；accRange 把区间分给 Lanes 个独立的
+// 补偿累加器（和与补偿分别存成数组），编译器可以把它们向量化，最后再合并。
+// 各累加器都是补偿求和，改变分组只影响舍入，因此声明为 associative。
+class KahanSumPolicy {
+  static constexpr std::size_t Lanes = 16;
+
+public:
+  static constexpr bool associative = true;
+  using Operation = SumOperation;
+  template <typename T1, typename T2>
+  static void acc(KahanSum<T1> &total, T2 const &right) {
+    total.add(T1(right));
+  }
+  template <typename T1>
+  static void combine(KahanSum<T1> &total, KahanSum<T1> const &partial) {
+    total.add(partial.sum);
+    total.add(-partial.compensation);
+  }
+  template <typename T1, typename T2>
+  static void accRange(KahanSum<T1> &total, T2 const *begin, T2 const *end) {
+    T1 sums[Lanes] = {};
+    T1 compensations[Lanes] = {};
+    std::size_t n = std::size_t(end - begin);
+    std::size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+      for (std::size_t k = 0; k != Lanes; ++k) {
+        T1 y = T1(begin[i + k]) - compensations[k];
+        T1 t = sums[k] + y;
+        compensations[k] = (t - sums[k]) - y;
+        sums[k] = t;
+      }
+    }
+    for (std::size_t k = 0; k != Lanes; ++k) {
+      combine(total, KahanSum<T1>{sums[k], compensations[k]});
+    }
+    for (; i != n; ++i) {
+      total.add(T1(begin[i]));
+    }
+  }
+};
+
+// 两两求和：accRange 递归地把区间对半分，不超过 Block 个元素的块用 Lanes
+// 个独立累加器直接求和（可以向量化），再把各累加器两两相加。误差随长度
+// 按对数增长，而逐个累加时线性增长。逐个累加（acc）时退化为普通求和。
+class PairwiseSumPolicy {
+  static constexpr std::size_t Block = 256;
+  static constexpr std::size_t Lanes = 16;
+
+  template <typename T1, typename T2>
+  static T1 blockSum(T2 const *begin, std::size_t n) {
+    T1 lanes[Lanes] = {};
+    std::size_t full = n / Lanes * Lanes;
+    for (std::size_t i = 0; i != full; i += Lanes) {
+      for (std::size_t k = 0; k != Lanes; ++k) {
+        lanes[k] += T1(begin[i + k]);
+      }
+    }
+    for (std::size_t k = 0; k != n % Lanes; ++k) {
+      lanes[k] += T1(begin[full + k]);
+    }
+    for (std::size_t width = Lanes / 2; width != 0; width /= 2) {
+      for (std::size_t k = 0; k != width; ++k) {
+        lanes[k] += lanes[k + width];
+      }
+    }
+    return lanes[0];
+  }
+
+  template <typename T1, typename T2>
+  static T1 pairwiseSum(T2 const *begin, std::size_t n) {
+    if (n <= Block) {
+      return blockSum<T1>(begin, n);
+    }
+    std::size_t half = (n / Block + 1) / 2 * Block; // 前一半按块对齐
+    return pairwiseSum<T1>(begin, half) +
+           pairwiseSum<T1>(begin + half, n - half);
+  }
+
+public:
+  static constexpr bool associative = true;
+  using Operation = SumOperation;
+  template <typename T1, typename T2>
+  static void acc(T1 &total, T2 const &right) {
+    total += right;
+  }
+  template <typename T1> static void combine(T1 &total, T1 const &partial) {
+    total += partial;
+  }
+  template <typename T1, typename T2>
+  static void accRange(T1 &total, T2 const *begin, T2 const *end) {
+    total += pairwiseSum<T1>(begin, std::size_t(end - begin));
+  }
+};
@@ -20,7 +20,7 @@ public:
       }
     }
     // there is no element with this key; add one
-    data.push_back(pair<Key const, Value>(key, Value()));
+    data.push_back(std::pair<Key const, Value>(key, Value()));
     return data.back().second;
   }
   // ...
@@ -42,7 +42,7 @@ public:
 template <typename Key, typename Value>
 class Dictionary<
     Key, Value,
-    std::enable_if_t<hasLess(type<int>, type<int>) && !hasHash(type<Key>)>> {
+    std::enable_if_t<hasLess(type<Key>, type<Key>) && !hasHash(type<Key>)>> {
 private:
   std::map<Key const, Value> data;
 
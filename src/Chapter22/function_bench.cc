@@ -0,0 +1,122 @@
+// 回调参数的开销对比（forUpTo 的三种写法）：
+//   template    - 模板参数，调用可以被内联
+//   FunctionRef - 非拥有引用，两指针大小，一次间接调用
+//   FunctionPtr - 拥有函数对象，按值传参时需复制函数对象（较小的存放在内部，
+//                 否则在堆上），每次调用经由静态操作表的函数指针间接调用一次
+// 第一组在一次 forUpTo 中调用 n 次，比较每次调用的开销；第二组每次 forUpTo
+// 只调用一次，比较构造回调本身的开销（捕获较多时 FunctionPtr 需要堆分配）。
+// 第三组是过滤：对数组中每个元素求谓词，比较逐个调用与 invokeBatch。
+#include "function_ptr/function_ptr.h"
+#include "function_ptr/function_ref.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+template <typename F>
+[[gnu::noinline]] void forUpToTemplate(int n, F f) {
+  for (int i = 0; i != n; ++i) {
+    f(i);
+  }
+}
+
+[[gnu::noinline]] void forUpToRef(int n, FunctionRef<void(int)> f) {
+  for (int i = 0; i != n; ++i) {
+    f(i);
+  }
+}
+
+[[gnu::noinline]] void forUpToPtr(int n, FunctionPtr<void(int)> f) {
+  for (int i = 0; i != n; ++i) {
+    f(i);
+  }
+}
+
+template <typename F> double measure(long calls, F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         double(calls);
+}
+
+int main() {
+  constexpr int N = 1 << 24;
+  volatile long sink = 0;
+
+  {
+    long sum = 0;
+    auto add = [&sum](int i) { sum = sum * 31 + i; };
+    double t = measure(N, [&] { forUpToTemplate(N, add); });
+    double r = measure(N, [&] { forUpToRef(N, add); });
+    double p = measure(N, [&] { forUpToPtr(N, add); });
+    sink = sum;
+    std::printf("per call:        template %5.2f ns  FunctionRef %5.2f ns  "
+                "FunctionPtr %5.2f ns\n",
+                t, r, p);
+  }
+
+  {
+    constexpr int Calls = 1 << 22;
+    long sum = 0, a = 1, b = 2, c = 3, d = 4;
+    // 捕获五个变量，超出 FunctionPtr 的内联容量
+    auto add = [&sum, a, b, c, d](int i) { sum += i + a + b + c + d; };
+    double t = measure(Calls, [&] {
+      for (int k = 0; k != Calls; ++k)
+        forUpToTemplate(1, add);
+    });
+    double r = measure(Calls, [&] {
+      for (int k = 0; k != Calls; ++k)
+        forUpToRef(1, add);
+    });
+    double p = measure(Calls, [&] {
+      for (int k = 0; k != Calls; ++k)
+        forUpToPtr(1, add);
+    });
+    sink = sum;
+    std::printf("per forUpTo(1):  template %5.2f ns  FunctionRef %5.2f ns  "
+                "FunctionPtr %5.2f ns\n",
+                t, r, p);
+  }
+
+  {
+    constexpr int Count = 1 << 20, Rounds = 50;
+    std::vector<int> values(Count);
+    for (int i = 0; i != Count; ++i) {
+      values[i] = (i * 37) % 1000;
+    }
+    auto keep = std::make_unique<bool[]>(Count);
+    int threshold = 500;
+    auto pred = [threshold](int x) { return x > threshold; };
+    FunctionPtr<bool(int)> erased = pred;
+
+    auto count = [&] {
+      long kept = 0;
+      for (int i = 0; i != Count; ++i)
+        kept += keep[i];
+      return kept;
+    };
+    long direct = 0, single = 0, batch = 0;
+    double t = measure(long(Count) * Rounds, [&] {
+      for (int r = 0; r != Rounds; ++r)
+        for (int i = 0; i != Count; ++i)
+          keep[i] = pred(values[i]);
+      direct = count();
+    });
+    double p = measure(long(Count) * Rounds, [&] {
+      for (int r = 0; r != Rounds; ++r)
+        for (int i = 0; i != Count; ++i)
+          keep[i] = erased(values[i]);
+      single = count();
+    });
+    double b = measure(long(Count) * Rounds, [&] {
+      for (int r = 0; r != Rounds; ++r)
+        erased.invokeBatch({keep.get(), Count}, values);
+      batch = count();
+    });
+    std::printf("filter element:  template %5.2f ns  FunctionPtr %5.2f ns  "
+                "invokeBatch %5.2f ns  (%s)\n",
+                t, p, b, direct == single && single == batch ? "ok" : "MISMATCH");
+  }
+  (void)sink;
+}
@@ -1,50 +1,170 @@
+#pragma once
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
-template <typename R, typename... Args> class FunctorBridge {
-public:
-  virtual ~FunctorBridge() {}
-  virtual FunctorBridge *clone() const = 0;
+// 批量调用时每个参数对应一个数组：按值或 const 引用传递的参数取 const 元素，
+// 非 const 引用参数取可修改的元素，右值引用参数的元素在调用时被移动。
+template <typename T>
+using BatchElement =
+    std::conditional_t<std::is_reference_v<T> &&
+                           !std::is_const_v<std::remove_reference_t<T>>,
+                       std::remove_reference_t<T>, std::remove_cvref_t<T> const>;
+
+// 批量调用的结果数组元素类型，返回 void 时不需要结果数组
+template <typename R> using BatchResult = std::conditional_t<std::is_void_v<R>, void, R>;
 
-  // 将 invoke() 设为 const，为的是避免通过 const 函数 ptr 对象调用非 const
-  // 操作符 () 重载，这与开发者的预期不符。
-  virtual R invoke(Args... args) const = 0;
+// 数组元素能否按参数的传递方式交给函数：右值引用参数从元素移动，其余从元素复制
+template <typename Arg>
+constexpr bool IsBatchPassable =
+    std::is_rvalue_reference_v<Arg>
+        ? std::is_constructible_v<Arg, BatchElement<Arg> &&>
+        : std::is_constructible_v<Arg, BatchElement<Arg> &>;
 
-  // 判断是否调用同一个函数
-  virtual bool equals(const FunctorBridge *other) const = 0;
+// 只有结果能赋值给数组元素、参数能从数组元素传入的签名才支持批量调用。
+// 返回引用、参数只能移动的签名仍然可以构造 FunctionPtr，只是不能批量调用。
+template <typename R, typename... Args>
+concept BatchInvocable =
+    (std::is_void_v<R> ||
+     (std::is_object_v<R> && std::is_assignable_v<R &, R>)) &&
+    (IsBatchPassable<Args> && ...);
+
+// 操作表中批量调用入口的类型；不支持批量调用的签名只占一个空指针，
+// 不会形成 BatchResult<R> * 这样不合法的类型
+template <typename R, typename... Args> struct BatchInvokerT {
+  using Type = void (*)();
+};
+template <typename R, typename... Args>
+  requires BatchInvocable<R, Args...>
+struct BatchInvokerT<R, Args...> {
+  using Type = void (*)(void const *functor, std::size_t n,
+                        BatchResult<R> *results, BatchElement<Args> *...args);
 };
 
-template <typename Functor, typename R, typename... Args>
-class SpecificFunctorBridge : public FunctorBridge<R, Args...> {
-  Functor functor;
+// 不使用虚函数的桥接：每种函数对象类型在编译期生成一张静态操作表，
+// FunctionPtr 保存函数对象的地址和这张表。操作表的地址本身就是类型标签，
+// 比较两个 FunctionPtr 是否为同一类型只需比较指针，不依赖 RTTI。
+template <typename R, typename... Args> struct FunctorBridge {
+  // 将 invoke 的函数对象参数设为 const，为的是避免通过 const 函数 ptr
+  // 对象调用非 const 操作符 () 重载，这与开发者的预期不符。
+  R (*invoke)(void const *functor, Args... args);
+
+  // 对 n 组参数依次调用，第 i 次调用的参数为 args[i]...，结果写入 results[i]。
+  // 第 i 次调用只读写各数组的第 i 个元素，results 可以与参数数组重叠（原地计算）。
+  // 循环在知道函数对象类型的地方实例化，函数对象可以被内联，循环可以被向量化。
+  // 不满足 BatchInvocable 的签名为空指针。
+  typename BatchInvokerT<R, Args...>::Type invokeBatch;
+
+  void *(*clone)(void const *functor);                  // 在堆上复制
+  void (*cloneInto)(void const *functor, void *buffer); // 复制到缓冲区
+  void (*moveInto)(void *functor, void *buffer);        // 移动到缓冲区
+  void (*destroy)(void *functor);                       // 只调用析构函数
+  void (*deallocate)(void *functor);                    // 析构并释放堆内存
+
+  // 判断是否调用同一个函数，调用前两边的操作表必须相同
+  bool (*equals)(void const *functor, void const *other);
+};
+
+// 直接比较函数对象会在没有合适的 == 运算符时（比如 lambda）出现编译错误，
+// 因此通过 SFINAE 检查类型的 == 运算符是否存在。
+template <typename T> class IsEqualityComparable {
+private:
+  // test convertibility of == and !(==) to bool:
+  static void *conv(bool);
+  template <typename U>
+  static std::true_type
+      test(decltype(conv(std::declval<U const &>() ==
+                         std::declval<U const &>())),
+           decltype(conv(!(std::declval<U const &>() ==
+                           std::declval<U const &>()))));
+  // fallback:
+  template <typename U> static std::false_type test(...);
 
 public:
-  template <typename FunctorFwd>
-  SpecificFunctorBridge(FunctorFwd &&ifunctor)
-      : functor(std::forward<FunctorFwd>(ifunctor)) {}
+  static constexpr bool value = decltype(test<T>(nullptr, nullptr))::value;
+};
+
+// 不可比较的函数对象（如 lambda）视为不相等
+template <typename T, bool EqComparable = IsEqualityComparable<T>::value>
+struct TryEquals {
+  static bool equals(T const &x1, T const &x2) { return x1 == x2; }
+};
+
+template <typename T> struct TryEquals<T, false> {
+  static bool equals(T const &, T const &) { return false; }
+};
 
-  virtual FunctorBridge<R, Args...> *clone() const override {
-    return new SpecificFunctorBridge(functor);
+template <typename Functor, typename R, typename... Args>
+class SpecificFunctorBridge {
+  static Functor const &self(void const *functor) {
+    return *static_cast<Functor const *>(functor);
   }
 
-  virtual R invoke(Args... args) const override {
-    return functor(std::forward<Args>(args)...);
+  static R invoke(void const *functor, Args... args) {
+    return self(functor)(std::forward<Args>(args)...);
+  }
+  template <typename Arg> static Arg pass(BatchElement<Arg> &elem) {
+    if constexpr (std::is_rvalue_reference_v<Arg>) {
+      return std::move(elem);
+    } else {
+      return elem;
+    }
+  }
+  // 模板形式推迟实例化：只有满足 BatchInvocable 时才会取它的地址
+  template <typename Result = R>
+  static void invokeBatch(void const *functor, std::size_t n,
+                          BatchResult<Result> *results,
+                          BatchElement<Args> *...args) {
+    Functor const &f = self(functor);
+    auto call = [&](std::size_t i) {
+      if constexpr (std::is_void_v<Result>) {
+        f(pass<Args>(args[i])...);
+      } else {
+        results[i] = f(pass<Args>(args[i])...);
+      }
+    };
+    // 固定长度的内层循环便于编译器展开和向量化，剩余部分逐个调用
+    constexpr std::size_t Block = 16;
+    std::size_t i = 0;
+    for (; i + Block <= n; i += Block) {
+      for (std::size_t k = 0; k != Block; ++k) {
+        call(i + k);
+      }
+    }
+    for (; i != n; ++i) {
+      call(i);
+    }
   }
 
-  virtual bool equals(FunctorBridge<R, Args...> const *fb) const override {
-    auto specFb =
-        dynamic_cast<SpecificFunctorBridge<Functor, R, Args...> const *>(fb);
+  static void *clone(void const *functor) { return new Functor(self(functor)); }
+  static void cloneInto(void const *functor, void *buffer) {
+    new (buffer) Functor(self(functor));
+  }
+  static void moveInto(void *functor, void *buffer) {
+    new (buffer) Functor(std::move(*static_cast<Functor *>(functor)));
+  }
+  static void destroy(void *functor) {
+    static_cast<Functor *>(functor)->~Functor();
+  }
+  static void deallocate(void *functor) {
+    delete static_cast<Functor *>(functor);
+  }
+  static bool equals(void const *functor, void const *other) {
+    return TryEquals<Functor>::equals(self(functor), self(other));
+  }
 
-    if (specFb) {
-      // return functor == specFb->functor;
+  static constexpr typename BatchInvokerT<R, Args...>::Type batchInvoker() {
+    if constexpr (BatchInvocable<R, Args...>) {
+      return &invokeBatch<R>;
+    } else {
+      return nullptr;
     }
-    return false;
   }
 
-  // 但是上述实现存在缺点，如果 bridge 不存在合适的 == 运算符，比如
-  // lambda，那么将会出现编译错误。那么我们可以在 function_ptr 比较的时候 check
-  // 类型的 == 运算符是否存在。
-
-  // 可以通过 SNIFAE 技术完成。
-};
\ No newline at end of file
+public:
+  static constexpr FunctorBridge<R, Args...> ops{
+      &invoke, batchInvoker(), &clone, &cloneInto, &moveInto, &destroy, &deallocate, &equals};
+};
@@ -1,64 +1,160 @@
+#pragma once
 #include "function_bridge.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <span>
 #include <type_traits>
 #include <utility>
 
-template <typename R, typename... Args> class FunctionPtr;
+// InlineSize：可以直接存放在 FunctionPtr 内部的函数对象大小，默认 3 个指针
+template <typename Signature, std::size_t InlineSize = 3 * sizeof(void *)>
+class FunctionPtr;
 
-template <typename R, typename... Args> class FunctionPtr<R(Args...)> {
+template <typename R, typename... Args, std::size_t InlineSize>
+class FunctionPtr<R(Args...), InlineSize> {
 private:
-  FunctorBridge<R, Args...> *bridge;
+  using Bridge = FunctorBridge<R, Args...>;
+
+  // 小对象优化：足够小且移动不抛异常的函数对象直接放在 storage 中，
+  // 只有较大的函数对象才在堆上分配。
+  alignas(void *) unsigned char storage[InlineSize];
+  void *functor;       // 指向 storage 或堆上的函数对象
+  Bridge const *ops;   // 函数对象类型的操作表，同时作为类型标签
+  // 从操作表中复制出来，调用时少一次间接访问
+  R (*invoker)(void const *, Args...);
+
+  template <typename Functor>
+  static constexpr bool fitsInline =
+      sizeof(Functor) <= InlineSize && alignof(Functor) <= alignof(void *) &&
+      std::is_nothrow_move_constructible_v<Functor>;
+
+  bool isInline() const {
+    return functor == static_cast<void const *>(storage);
+  }
+
+  void copyFrom(FunctionPtr const &other) {
+    ops = other.ops;
+    invoker = other.invoker;
+    if (!other.ops) {
+      functor = nullptr;
+    } else if (other.isInline()) {
+      other.ops->cloneInto(other.functor, storage);
+      functor = storage;
+    } else {
+      functor = other.ops->clone(other.functor);
+    }
+  }
+
+  // 内联存放的函数对象移动不抛异常，堆上的只转移指针
+  void moveFrom(FunctionPtr &other) noexcept {
+    ops = other.ops;
+    invoker = other.invoker;
+    if (other.ops && other.isInline()) {
+      other.ops->moveInto(other.functor, storage);
+      functor = storage;
+      other.reset();
+    } else {
+      functor = other.functor;
+      other.functor = nullptr;
+      other.ops = nullptr;
+      other.invoker = nullptr;
+    }
+  }
+
+  void reset() noexcept {
+    if (ops) {
+      if (isInline()) {
+        ops->destroy(functor);
+      } else {
+        ops->deallocate(functor);
+      }
+    }
+    functor = nullptr;
+    ops = nullptr;
+    invoker = nullptr;
+  }
 
 public:
   // constructors:
-  FunctionPtr() : bridge(nullptr) {}
-  FunctionPtr(FunctionPtr const &other) : bridge(nullptr) {
-    if (other.bridge)
-      bridge = other.bridge->clone();
-  }
+  FunctionPtr() : functor(nullptr), ops(nullptr), invoker(nullptr) {}
+  FunctionPtr(FunctionPtr const &other) { copyFrom(other); }
   FunctionPtr(FunctionPtr &other)
       : FunctionPtr(static_cast<FunctionPtr const &>(other)) {}
-  FunctionPtr(FunctionPtr &&other) : bridge(other.bridge) {
-    other.bridge = nullptr;
-  }
+  FunctionPtr(FunctionPtr &&other) noexcept { moveFrom(other); }
 
   // 从任意对象进行构造
-  template <typename F> FunctionPtr(F &&f) : bridge(nullptr) {
+  template <typename F> FunctionPtr(F &&f) {
     using FunctionType = std::decay_t<F>;
-    using Bridge = SpecificFunctorBridge<FunctionType, R, Args...>;
-    bridge = new Bridge(std::forward<F>(f));
+    using Specific = SpecificFunctorBridge<FunctionType, R, Args...>;
+    if constexpr (fitsInline<FunctionType>) {
+      functor = new (storage) FunctionType(std::forward<F>(f));
+    } else {
+      functor = new FunctionType(std::forward<F>(f));
+    }
+    ops = &Specific::ops;
+    invoker = ops->invoke;
   }
 
   // assignment operators:
   FunctionPtr &operator=(FunctionPtr const &other) {
-    FunctionPtr tmp(other);
-    swap(*this, tmp);
+    if (this != &other) {
+      FunctionPtr tmp(other);
+      reset();
+      moveFrom(tmp);
+    }
     return *this;
   }
-  FunctionPtr &operator=(FunctionPtr &&other) {
-    delete bridge;
-    bridge = other.bridge;
-    other.bridge = nullptr;
+  FunctionPtr &operator=(FunctionPtr &&other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(other);
+    }
     return *this;
   }
 
   // construction and assignment from arbitrary function objects:
   template <typename F> FunctionPtr &operator=(F &&f) {
     FunctionPtr tmp(std::forward<F>(f));
-    swap(*this, tmp);
+    reset();
+    moveFrom(tmp);
     return *this;
   }
   // destructor:
-  ~FunctionPtr() { delete bridge; }
+  ~FunctionPtr() { reset(); }
 
   friend void swap(FunctionPtr &fp1, FunctionPtr &fp2) {
-    std::swap(fp1.bridge, fp2.bridge);
+    FunctionPtr tmp(std::move(fp1));
+    fp1 = std::move(fp2);
+    fp2 = std::move(tmp);
   }
   explicit operator bool() const {
-    return bridge != nullptr;
+    return ops != nullptr;
   }
   // invocation:
   R operator()(Args... args) const {
-    return bridge->invoke(std::forward<Args>(args)...);
+    return invoker(functor, std::forward<Args>(args)...);
+  }
+
+  // 批量调用：对每组参数 (args[i]...) 调用一次，整个批次只有一次间接调用。
+  // 各数组的长度必须相同；结果数组可以就是某个参数数组（原地计算）。
+  // 只对满足 BatchInvocable 的签名提供。
+  template <typename Result = R>
+    requires(!std::is_void_v<Result> && BatchInvocable<Result, Args...>)
+  void invokeBatch(std::type_identity_t<std::span<Result>> results,
+                   std::span<BatchElement<Args>>... args) const {
+    assert(((args.size() == results.size()) && ...));
+    ops->invokeBatch(functor, results.size(), results.data(), args.data()...);
+  }
+  template <typename Result = R>
+    requires(std::is_void_v<Result> && sizeof...(Args) != 0 &&
+             BatchInvocable<Result, Args...>)
+  void invokeBatch(std::span<BatchElement<Args>>... args) const {
+    std::size_t const sizes[] = {args.size()...};
+    assert(std::all_of(std::begin(sizes), std::end(sizes),
+                       [&](std::size_t size) { return size == sizes[0]; }));
+    ops->invokeBatch(functor, sizes[0], nullptr, args.data()...);
   }
 
   // check whether call the same function
@@ -66,10 +162,10 @@ public:
     if (!f1 || !f2) {
       return !f1 && !f2;
     }
-    return f1.bridge->equals(f2.bridge);
+    return f1.ops == f2.ops && f1.ops->equals(f1.functor, f2.functor);
   }
 
   friend bool operator!=(FunctionPtr const &f1, FunctionPtr const &f2) {
     return !(f1 == f2);
   }
-};
\ No newline at end of file
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// FunctionRef：不拥有函数对象的轻量引用，只有两个指针大小。
+// 适合作为回调参数：绑定任意可调用对象都不需要分配内存，调用只是一次间接
+// 函数调用。它不延长被引用对象的生命周期，因此不能保存到调用结束之后。
+template <typename Signature> class FunctionRef;
+
+template <typename R, typename... Args> class FunctionRef<R(Args...)> {
+private:
+  // 函数对象保存其地址；普通函数保存函数指针本身，避免引用临时的指针变量
+  union Target {
+    void const *object;
+    void (*function)();
+  };
+
+  Target target;
+  R (*callback)(Target, Args...);
+
+public:
+  template <typename F>
+    requires(!std::is_same_v<std::decay_t<F>, FunctionRef> &&
+             std::is_invocable_r_v<R, F &, Args...>)
+  FunctionRef(F &&f) {
+    using Fn = std::remove_reference_t<F>;
+    if constexpr (std::is_function_v<std::remove_pointer_t<Fn>>) {
+      using Pointer = std::add_pointer_t<std::remove_pointer_t<Fn>>;
+      target.function = reinterpret_cast<void (*)()>(static_cast<Pointer>(f));
+      callback = [](Target t, Args... args) -> R {
+        return reinterpret_cast<Pointer>(t.function)(
+            std::forward<Args>(args)...);
+      };
+    } else {
+      target.object = std::addressof(f);
+      callback = [](Target t, Args... args) -> R {
+        return (*static_cast<Fn *>(const_cast<void *>(t.object)))(
+            std::forward<Args>(args)...);
+      };
+    }
+  }
+
+  FunctionRef(FunctionRef const &) = default;
+  FunctionRef &operator=(FunctionRef const &) = default;
+
+  R operator()(Args... args) const {
+    return callback(target, std::forward<Args>(args)...);
+  }
+};
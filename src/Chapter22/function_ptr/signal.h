@@ -0,0 +1,98 @@
+#pragma once
+#include "../../Common/epoch.h"
+#include "function_ptr.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 多播信号：保存一组 FunctionPtr<void(Args...)> 订阅者，emit 依次调用它们。
+// 订阅者列表是不可变的快照，订阅和退订时在互斥锁下复制出新列表再原子地替换
+// （写时复制），emit 只读取当前快照，从不加锁，也不会被订阅变动阻塞。
+//
+// 旧快照按纪元回收（Common/epoch.h）：emit 期间当前线程处于读临界区，写者
+// 替换快照之后，等所有在替换之前开始的 emit 结束再释放旧快照。emit 只写
+// 线程自己的纪元记录，不同线程的 emit 不竞争同一个缓存行。写者不等待读者，
+// 因此在回调中订阅或退订也是安全的；旧快照在之后的订阅或退订中回收。
+template <typename Signature> class Signal;
+
+template <typename... Args> class Signal<void(Args...)> {
+public:
+  using Slot = FunctionPtr<void(Args...)>;
+  using Connection = std::uint64_t;
+
+private:
+  struct Subscriber {
+    Connection id;
+    Slot slot;
+  };
+  using List = std::vector<Subscriber>;
+
+  std::atomic<List const *> current;
+
+  // 以下成员只在 writeMutex 保护下访问
+  mutable std::mutex writeMutex;
+  RetireList<List> retired;
+  Connection nextId = 1;
+
+  // 调用者持有 writeMutex
+  void publish(List const *fresh) { retired.retire(current.exchange(fresh)); }
+
+public:
+  Signal() : current(new List) {}
+  Signal(Signal const &) = delete;
+  Signal &operator=(Signal const &) = delete;
+
+  // 析构时不能有正在进行的 emit；retired 中的旧快照随之释放
+  ~Signal() { delete current.load(); }
+
+  template <typename F> Connection subscribe(F &&f) {
+    Slot slot(std::forward<F>(f));
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto fresh = new List(*current.load());
+    fresh->push_back(Subscriber{nextId, std::move(slot)});
+    publish(fresh);
+    return nextId++;
+  }
+
+  // 退订；连接不存在时返回 false。返回后新的 emit 不会再调用该订阅者，
+  // 但已经开始的 emit 可能仍在使用旧快照调用它。
+  bool unsubscribe(Connection id) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    List const *list = current.load();
+    auto fresh = new List;
+    fresh->reserve(list->size());
+    for (Subscriber const &subscriber : *list) {
+      if (subscriber.id != id) {
+        fresh->push_back(subscriber);
+      }
+    }
+    if (fresh->size() == list->size()) {
+      delete fresh;
+      return false;
+    }
+    publish(fresh);
+    return true;
+  }
+
+  std::size_t size() const {
+    EpochGuard guard;
+    return current.load()->size();
+  }
+
+  // 等待回收的旧快照个数
+  std::size_t retiredCount() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return retired.size();
+  }
+
+  void emit(Args... args) const {
+    EpochGuard guard;
+    List const *list = current.load();
+    for (Subscriber const &subscriber : *list) {
+      subscriber.slot(args...);
+    }
+  }
+
+  void operator()(Args... args) const { emit(args...); }
+};
@@ -0,0 +1,257 @@
+#pragma once
+#include "function_ptr.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 执行 FunctionPtr<void()> 任务的工作窃取线程池。
+// 每个工作线程有自己的双端队列：工作线程提交的任务放入自己队列的尾部并从
+// 尾部取出（后进先出，缓存友好），空闲的线程从其他队列的头部窃取。外部线程
+// 提交的任务轮流分配到各个队列。每个队列有自己的锁，线程之间只在窃取时竞争。
+// 任务是 FunctionPtr，捕获不超过三个指针的任务存放在内联缓冲区中，不需要为
+// 每个任务分配堆内存。
+class ThreadPool {
+public:
+  using Task = FunctionPtr<void()>;
+
+private:
+  struct alignas(64) Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<std::size_t> pending{0};  // 队列中的任务数，在队列锁内增减
+  std::atomic<std::size_t> sleepers{0}; // 正在等待任务的线程数
+  std::atomic<std::size_t> nextQueue{0};
+  std::atomic<bool> stopping{false};
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+
+  // 当前线程所属的线程池和队列下标，非工作线程为 nullptr
+  static inline thread_local ThreadPool *currentPool = nullptr;
+  static inline thread_local std::size_t currentIndex = 0;
+
+  std::size_t targetQueue() {
+    if (currentPool == this) {
+      return currentIndex;
+    }
+    return nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+  }
+
+  void notify(std::size_t count) {
+    // pending 的递增与 sleepers 的检查构成 Dekker 式的握手：等待的线程要么
+    // 在谓词中看到新的任务，要么被这里唤醒
+    if (sleepers.load() != 0) {
+      { std::lock_guard<std::mutex> lock(sleepMutex); }
+      if (count == 1) {
+        wakeUp.notify_one();
+      } else {
+        wakeUp.notify_all();
+      }
+    }
+  }
+
+  bool popFrom(std::size_t index, bool back, Task &task) {
+    Queue &queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    if (back) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    pending.fetch_sub(1);
+    return true;
+  }
+
+  // 先取自己队列的尾部，再依次窃取其他队列的头部
+  bool tryPop(Task &task) {
+    std::size_t n = queues.size();
+    std::size_t self = currentPool == this ? currentIndex : 0;
+    if (currentPool == this && popFrom(self, true, task)) {
+      return true;
+    }
+    for (std::size_t k = 1; k <= n; ++k) {
+      std::size_t victim = (self + k) % n;
+      if (popFrom(victim, false, task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void workerLoop(std::size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    Task task;
+    for (;;) {
+      if (tryPop(task)) {
+        task();
+        task = Task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      sleepers.fetch_add(1);
+      wakeUp.wait(lock, [this] { return pending.load() != 0 || stopping; });
+      sleepers.fetch_sub(1);
+      if (stopping && pending.load() == 0) {
+        return;
+      }
+    }
+  }
+
+public:
+  explicit ThreadPool(
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i != threads; ++i) {
+      queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i != threads; ++i) {
+      workers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+
+  // 执行完所有已提交的任务后再退出
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  // 进程内共享的线程池，第一次使用时按硬件线程数创建
+  static ThreadPool &shared() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  std::size_t size() const { return workers.size(); }
+
+  // 提交不需要结果的任务；任务抛出的异常会终止程序
+  void post(Task task) {
+    Queue &queue = *queues[targetQueue()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+      pending.fetch_add(1);
+    }
+    notify(1);
+  }
+
+  // 批量提交：一次加锁放入同一个队列，空闲线程会从中窃取
+  void postBatch(std::vector<Task> tasks) {
+    if (tasks.empty()) {
+      return;
+    }
+    Queue &queue = *queues[targetQueue()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      for (Task &task : tasks) {
+        queue.tasks.push_back(std::move(task));
+      }
+      pending.fetch_add(tasks.size());
+    }
+    notify(tasks.size());
+  }
+
+  // 提交任务并通过 future 取得结果或异常
+  template <typename F> auto submit(F &&f) {
+    using R = std::invoke_result_t<std::decay_t<F> &>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> result = task->get_future();
+    post([task] { (*task)(); });
+    return result;
+  }
+
+  // 在调用线程上执行一个待处理的任务，没有任务时返回 false
+  bool runPending() {
+    Task task;
+    if (!tryPop(task)) {
+      return false;
+    }
+    task();
+    return true;
+  }
+
+  // 把 [begin, end) 切成大小为 grain 的块并行执行 body(i)。
+  // 调用线程在等待期间也执行任务，因此可以在工作线程中嵌套调用。
+  // body 抛出异常时该块的其余下标被跳过，等所有块结束后在调用线程重新抛出
+  // 第一个异常；块引用的 body 和上下文在所有块结束之前都不会被销毁。
+  template <typename Body>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   Body const &body) {
+    if (begin >= end) {
+      return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    struct Context {
+      Body const *body;
+      std::size_t end;
+      std::atomic<std::size_t> remaining;
+      std::exception_ptr error;
+      std::mutex errorMutex;
+
+      void run(std::size_t lo, std::size_t hi) noexcept {
+        try {
+          for (std::size_t i = lo; i != hi; ++i) {
+            (*body)(i);
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(errorMutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+      }
+    };
+    std::size_t chunks = (end - begin + grain - 1) / grain;
+    Context context{&body, end, chunks, nullptr, {}};
+
+    // 每个块只捕获上下文指针和区间，正好放进 FunctionPtr 的内联缓冲区
+    std::vector<Task> tasks;
+    tasks.reserve(chunks - 1);
+    for (std::size_t lo = begin + grain; lo < end; lo += grain) {
+      tasks.emplace_back([ctx = &context, lo, grain] {
+        ctx->run(lo, std::min(lo + grain, ctx->end));
+      });
+    }
+    postBatch(std::move(tasks));
+
+    // 第一个块由调用线程直接执行
+    context.run(begin, std::min(begin + grain, end));
+
+    while (context.remaining.load(std::memory_order_acquire) != 0) {
+      if (!runPending()) {
+        std::this_thread::yield();
+      }
+    }
+    if (context.error) {
+      std::rethrow_exception(context.error);
+    }
+  }
+};
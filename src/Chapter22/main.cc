@@ -1,13 +1,58 @@
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "function_ptr/function_ptr.h"
+#include "function_ptr/function_ref.h"
+#include "function_ptr/signal.h"
+#include "function_ptr/thread_pool.h"
+
+// 统计堆分配次数，用来观察 FunctionPtr 的小对象优化。
+// 替换全部的单对象、数组和带大小的形式；不内联，否则优化后 GCC 会把
+// new 表达式和内联进来的 free 配对，误报 -Wmismatched-new-delete。
+static std::atomic<std::size_t> allocations{0};
+
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+[[gnu::noinline]] void *operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void *p) noexcept {
+  ::operator delete(p);
+}
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept {
+  ::operator delete(p);
+}
+[[gnu::noinline]] void operator delete[](void *p, std::size_t) noexcept {
+  ::operator delete(p);
+}
+
+template <typename F> std::size_t countAllocations(F f) {
+  std::size_t before = allocations;
+  f();
+  return allocations - before;
+}
 
 void print(int x) { printf("x: %d\n", x); }
 void print2(int x) { printf("x: %d\n", x); }
 
-void fun(int x, FunctionPtr<void(int)> f) { f(x); }
+// 只在调用期间使用回调，不需要拥有它：FunctionRef 不分配内存
+void fun(int x, FunctionRef<void(int)> f) { f(x); }
 
 void fun(FunctionPtr<void(int)> f1, FunctionPtr<void(int)> f2) {
   std::cout << (f1 == f2);
@@ -26,4 +71,139 @@ int main() {
   fun(3, print);
   printf("Print: %p\n", print);
   fun(print, print2);
+  fun(print, print);
+  printf("\n");
+
+  // 移动不抛异常，std::vector 扩容时移动而不是复制各个 FunctionPtr
+  static_assert(std::is_nothrow_move_constructible_v<FunctionPtr<void()>>);
+  static_assert(std::is_nothrow_move_assignable_v<FunctionPtr<void()>>);
+
+  // 函数指针和只捕获少量变量的 lambda 放在 FunctionPtr 内部，复制和移动都不分配
+  printf("function pointer: %zu allocations\n", countAllocations([] {
+           FunctionPtr<void(int)> f = print;
+           FunctionPtr<void(int)> g = f;
+           FunctionPtr<void(int)> h = std::move(g);
+           h(1);
+         }));
+  printf("small lambda: %zu allocations\n", countAllocations([&y] {
+           FunctionPtr<void(int)> f = [&y](int x) { y += x; };
+           FunctionPtr<void(int)> g = f;
+           FunctionPtr<void(int)> h = std::move(g);
+           h(1);
+         }));
+  // 超出内联容量的函数对象退回到堆分配：构造和每次复制各一次，移动只转移指针
+  printf("large lambda: %zu allocations\n", countAllocations([] {
+           long a = 1, b = 2, c = 3, d = 4;
+           FunctionPtr<void(int)> f = [a, b, c, d](int x) {
+             printf("sum: %ld\n", a + b + c + d + x);
+           };
+           FunctionPtr<void(int)> g = f;
+           FunctionPtr<void(int)> h = std::move(g);
+           h(0);
+         }));
+
+  // 批量调用：整个数组只经过一次类型擦除的间接调用
+  FunctionPtr<int(int, int)> add = [](int a, int b) { return a + b; };
+  int lhs[] = {1, 2, 3, 4}, rhs[] = {10, 20, 30, 40}, sums[4];
+  add.invokeBatch(sums, lhs, rhs);
+  printf("batch: %d %d %d %d\n", sums[0], sums[1], sums[2], sums[3]);
+  FunctionPtr<void(int &)> twice = [](int &x) { x *= 2; };
+  twice.invokeBatch(sums);
+  printf("batch: %d %d %d %d\n", sums[0], sums[1], sums[2], sums[3]);
+  add.invokeBatch(sums, sums, lhs); // 结果写回参数数组
+  printf("batch: %d %d %d %d\n", sums[0], sums[1], sums[2], sums[3]);
+
+  // 返回引用、参数只能移动的签名不支持批量调用，但仍然可以构造和调用
+  static_assert(!BatchInvocable<int &, int &>);
+  static_assert(!BatchInvocable<void, std::unique_ptr<int>>);
+  FunctionPtr<int &(int &)> self = [](int &x) -> int & { return x; };
+  self(y) = 7;
+  FunctionPtr<int(std::unique_ptr<int>)> consume =
+      [](std::unique_ptr<int> p) { return *p; };
+  printf("non-batch: %d %d\n", y, consume(std::make_unique<int>(8)));
+
+  // 多播信号：多个线程 emit 的同时另一个线程不断订阅和退订
+  Signal<void(int)> signal;
+  std::atomic<long> total{0};
+  signal.subscribe([&total](int x) { total += x; });
+  std::atomic<bool> done{false};
+  // emit 一直有重叠时旧快照也要被回收：待回收的个数保持很小
+  std::size_t publishes = 0, maxRetired = 0;
+  std::thread churn([&] {
+    while (!done) {
+      auto id = signal.subscribe([&total](int) { total += 0; });
+      signal.unsubscribe(id);
+      publishes += 2;
+      maxRetired = std::max(maxRetired, signal.retiredCount());
+    }
+  });
+  std::vector<std::thread> emitters;
+  for (int t = 0; t != 4; ++t) {
+    emitters.emplace_back([&signal] {
+      for (int i = 0; i != 100000; ++i) {
+        signal.emit(1);
+      }
+    });
+  }
+  for (auto &emitter : emitters) {
+    emitter.join();
+  }
+  done = true;
+  churn.join();
+  printf("signal: total %ld, %zu subscriber(s)\n", total.load(),
+         signal.size());
+  printf("signal: at most %zu of %zu old lists pending reclamation\n",
+         maxRetired, publishes);
+  // 没有进行中的 emit 时，下一次写入回收全部旧快照
+  signal.unsubscribe(signal.subscribe([](int) {}));
+  printf("signal: %zu old list(s) left\n", signal.retiredCount());
+
+  // 工作窃取线程池
+  {
+    ThreadPool pool(4);
+    auto answer = pool.submit([] { return 6 * 7; });
+    auto failed = pool.submit([]() -> int { throw std::runtime_error("oops"); });
+    printf("pool: submit %d\n", answer.get());
+    try {
+      failed.get();
+    } catch (std::exception const &e) {
+      printf("pool: exception %s\n", e.what());
+    }
+
+    std::vector<long> squares(1000);
+    std::size_t before = allocations;
+    pool.parallelFor(0, squares.size(), 64,
+                     [&squares](std::size_t i) { squares[i] = long(i * i); });
+    long sum = 0;
+    for (long x : squares) {
+      sum += x;
+    }
+    printf("pool: parallelFor sum %ld, %zu allocation(s)\n", sum,
+           allocations - before);
+
+    // 调用线程的块和工作线程的块都抛出异常：等所有块结束后重新抛出
+    std::atomic<int> visited{0};
+    try {
+      pool.parallelFor(0, 1000, 64, [&visited](std::size_t i) {
+        ++visited;
+        if (i == 0 || i == 500) {
+          throw std::runtime_error("chunk failed");
+        }
+      });
+    } catch (std::exception const &e) {
+      printf("pool: parallelFor exception %s, %d visited\n", e.what(),
+             visited.load());
+    }
+
+    std::atomic<int> counter{0};
+    std::vector<ThreadPool::Task> batch;
+    for (int i = 0; i != 100; ++i) {
+      batch.emplace_back([&counter] { ++counter; });
+    }
+    pool.postBatch(std::move(batch));
+    while (counter != 100) {
+      pool.runPending();
+    }
+    printf("pool: batch %d\n", counter.load());
+  }
 }
\ No newline at end of file
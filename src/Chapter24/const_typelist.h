@@ -42,4 +42,6 @@ void conslisttest() {
   using SortedTypes = InsertionSort<ConsList, SmallerThanT>;
   using Expected = Cons<char, Cons<short, Cons<int, Cons<double>>>>;
   std::cout << std::is_same<SortedTypes, Expected>::value << '\n';
+  std::cout << std::is_same<MergeSort<ConsList, SmallerThanT>, Expected>::value
+            << '\n';
 }
@@ -1,9 +1,13 @@
 #include "const_typelist.h"
 #include "non_type.h"
+#include "packed_record.h"
+#include "type_dispatch.h"
 #include "type_list.h"
 
 int main() {
   test();
   test_non_type();
   conslisttest();
+  test_type_dispatch();
+  test_packed_record();
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "type_list.h"
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <iostream>
+#include <utility>
 
 template <typename T, T Value> struct CTValue {
   static constexpr T value = Value;
@@ -56,6 +60,31 @@ struct GreaterThanT<CTValue<T, First>, CTValue<T, Second>> {
   static constexpr bool value = First > Second;
 };
 
+// Sort values
+// Valuelist 的值本身就是常量表达式，可以直接放进 constexpr 数组里用
+// std::sort 排序，再展开回 Valuelist，不需要为每次比较实例化一个类。
+// Compare 是作用在值上的比较函数对象（如 std::less<>），而不是元函数。
+template <typename List, typename Compare = std::less<>> class SortValuesT;
+
+template <typename T, T... Values, typename Compare>
+class SortValuesT<Valuelist<T, Values...>, Compare> {
+  static constexpr std::array<T, sizeof...(Values)> sorted = [] {
+    std::array<T, sizeof...(Values)> values{Values...};
+    std::sort(values.begin(), values.end(), Compare{});
+    return values;
+  }();
+
+  template <std::size_t... Is>
+  static Valuelist<T, sorted[Is]...> expand(std::index_sequence<Is...>);
+
+public:
+  using Type =
+      decltype(expand(std::make_index_sequence<sizeof...(Values)>()));
+};
+
+template <typename List, typename Compare = std::less<>>
+using SortValues = typename SortValuesT<List, Compare>::Type;
+
 // Deduce param
 template <auto Value> struct CTValue2 { static constexpr auto value = Value; };
 template <auto... Value> class Valuelist2 {};
@@ -81,6 +110,14 @@ void test_non_type() {
   static_assert(
       std::is_same_v<SortedIntegers, Valuelist<int, 9, 7, 6, 5, 4, 2, 2, 1>>,
       "insertion sort failed");
+  static_assert(std::is_same_v<MergeSort<Integers, GreaterThanT>,
+                               Valuelist<int, 9, 7, 6, 5, 4, 2, 2, 1>>,
+                "merge sort failed");
+  static_assert(std::is_same_v<SortValues<Integers, std::greater<>>,
+                               Valuelist<int, 9, 7, 6, 5, 4, 2, 2, 1>>);
+  static_assert(std::is_same_v<SortValues<Integers>,
+                               Valuelist<int, 1, 2, 2, 4, 5, 6, 7, 9>>);
+  static_assert(std::is_same_v<SortValues<Valuelist<int>>, Valuelist<int>>);
 
   // 测试 selectT
   using SignedIntegralTypes =
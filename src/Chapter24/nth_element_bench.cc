@@ -0,0 +1,31 @@
+// NthElement 的编译期开销：生成 SIZE 个不同类型组成的 Typelist，并索引其中
+// 的每一个元素。定义 RECURSIVE 时使用书中的递归实现作为对照。
+// 只需要编译（-fsyntax-only），见 CMakeLists.txt 中的 compile-bench。
+#include "type_list.h"
+#include <utility>
+
+#ifndef SIZE
+#define SIZE 50
+#endif
+
+template <std::size_t I> struct Tag {};
+
+template <std::size_t... Is>
+Typelist<Tag<Is>...> makeTagList(std::index_sequence<Is...>);
+
+using List = decltype(makeTagList(std::make_index_sequence<SIZE>()));
+
+#ifdef RECURSIVE
+template <std::size_t I>
+using At = typename NthElementRecursiveT<List, I>::Type;
+#else
+template <std::size_t I> using At = NthElement<List, I>;
+#endif
+
+template <std::size_t... Is> constexpr bool indexAll(std::index_sequence<Is...>) {
+  return (std::is_same_v<At<Is>, Tag<Is>> && ...);
+}
+
+static_assert(indexAll(std::make_index_sequence<SIZE>()));
+
+int main() {}
@@ -0,0 +1,147 @@
+#pragma once
+#include "type_list.h"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 紧凑记录
+// PackedRecord<Typelist<Fields...>> 按逻辑顺序声明字段，但在内存中按对齐
+// 从大到小（对齐相同时保持原顺序）排列。各类型的大小都是自身对齐的倍数，
+// 这样排列后字段之间不会有填充，只在末尾补齐到最大对齐，即最小的布局。
+// get<I>() 仍按逻辑下标访问，由编译期生成的逻辑 -> 物理下标表完成映射。
+
+// 带逻辑下标的字段
+template <std::size_t I, typename T> struct IndexedField {
+  static constexpr std::size_t index = I;
+  using Type = T;
+};
+
+template <typename T, typename U> struct AlignedBeforeT {
+  constexpr static bool value =
+      alignof(typename T::Type) > alignof(typename U::Type);
+};
+
+template <typename... Fields, std::size_t... Is>
+Typelist<IndexedField<Is, Fields>...> indexFields(Typelist<Fields...>,
+                                                  std::index_sequence<Is...>);
+
+// 物理顺序的字段列表
+template <typename... Fields>
+using PhysicalFields =
+    MergeSort<decltype(indexFields(Typelist<Fields...>(),
+                                   std::index_sequence_for<Fields...>())),
+              AlignedBeforeT>;
+
+// 按物理顺序嵌套存放字段。对齐从大到小排列时，嵌套的尾部不会引入额外的
+// 填充，整体大小与按同样顺序平铺的结构体相同。
+template <typename... Physical> struct PackedStorage {};
+
+template <typename Head> struct PackedStorage<Head> {
+  typename Head::Type head;
+
+  PackedStorage() = default;
+  template <typename... Args>
+  constexpr PackedStorage(std::tuple<Args...> &args)
+      : head(std::get<Head::index>(std::move(args))) {}
+};
+
+template <typename Head, typename... Tail>
+struct PackedStorage<Head, Tail...> {
+  typename Head::Type head;
+  PackedStorage<Tail...> tail;
+
+  PackedStorage() = default;
+  template <typename... Args>
+  constexpr PackedStorage(std::tuple<Args...> &args)
+      : head(std::get<Head::index>(std::move(args))), tail(args) {}
+};
+
+template <typename List> class PackedRecord;
+
+template <typename... Fields> class PackedRecord<Typelist<Fields...>> {
+  template <typename List> struct StorageT;
+  template <typename... Physical> struct StorageT<Typelist<Physical...>> {
+    using Type = PackedStorage<Physical...>;
+    static constexpr std::size_t logicalIndex[] = {Physical::index..., 0};
+  };
+  using Layout = StorageT<PhysicalFields<Fields...>>;
+
+  typename Layout::Type storage;
+
+  template <std::size_t P, typename Storage>
+  static constexpr auto &field(Storage &s) {
+    if constexpr (P == 0) {
+      return s.head;
+    } else {
+      return field<P - 1>(s.tail);
+    }
+  }
+
+public:
+  static constexpr std::size_t size = sizeof...(Fields);
+
+  // 逻辑下标为 I 的字段在物理布局中的位置
+  template <std::size_t I> static constexpr std::size_t physicalIndex() {
+    static_assert(I < size, "field index out of range");
+    std::size_t p = 0;
+    while (Layout::logicalIndex[p] != I) { // 每个逻辑下标恰好出现一次
+      ++p;
+    }
+    return p;
+  }
+
+  template <std::size_t I>
+  using FieldType = NthElement<Typelist<Fields...>, I>;
+
+  PackedRecord() = default;
+  // 按逻辑顺序给出各字段的初值
+  constexpr PackedRecord(Fields... values)
+    requires(sizeof...(Fields) > 0)
+      : PackedRecord(std::tuple<Fields...>(std::move(values)...)) {}
+
+  template <std::size_t I> constexpr FieldType<I> &get() {
+    return field<physicalIndex<I>()>(storage);
+  }
+  template <std::size_t I> constexpr FieldType<I> const &get() const {
+    return field<physicalIndex<I>()>(storage);
+  }
+
+private:
+  constexpr PackedRecord(std::tuple<Fields...> values) : storage(values) {}
+};
+
+void test_packed_record() {
+  using Fields = Typelist<char, double, short, int, char>;
+  using Record = PackedRecord<Fields>;
+  // 逻辑顺序 char, double, short, int, char 平铺需要 32 字节
+  struct Plain {
+    char a;
+    double b;
+    short c;
+    int d;
+    char e;
+  };
+  static_assert(sizeof(Plain) == 32);
+  // 物理顺序为 double, int, short, char, char
+  static_assert(sizeof(Record) == 16);
+  static_assert(Record::physicalIndex<1>() == 0);
+  static_assert(Record::physicalIndex<3>() == 1);
+  static_assert(Record::physicalIndex<2>() == 2);
+  static_assert(Record::physicalIndex<0>() == 3);
+  static_assert(Record::physicalIndex<4>() == 4);
+  static_assert(std::is_trivially_copyable_v<Record>);
+  static_assert(std::is_same_v<Record::FieldType<1>, double>);
+  static_assert(sizeof(PackedRecord<Typelist<>>) == 1);
+
+  constexpr Record constant('x', 1.5, 2, 3, 'y');
+  static_assert(constant.get<0>() == 'x' && constant.get<1>() == 1.5 &&
+                constant.get<4>() == 'y');
+
+  PackedRecord<Typelist<bool, std::string, int>> person(true, "name", 42);
+  person.get<2>() += 1;
+  std::cout << person.get<0>() << ' ' << person.get<1>() << ' '
+            << person.get<2>() << '\n';
+}
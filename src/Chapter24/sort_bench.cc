@@ -0,0 +1,42 @@
+// 编译期排序的开销：生成 SIZE 个 CTValue 组成的乱序 Typelist 并排序。
+// 默认使用 MergeSort；定义 INSERTION 时使用书中的 InsertionSort 作为对照，
+// 定义 VALUES 时对相同的值用 SortValues 做 constexpr 数组排序。
+// 只需要编译（-fsyntax-only），见 CMakeLists.txt 中的 compile-bench。
+#include "non_type.h"
+#include <utility>
+
+#ifndef SIZE
+#define SIZE 64
+#endif
+
+// SIZE 为 2 的幂，乘以奇数再取模得到 0..SIZE-1 的一个排列
+constexpr int shuffled(std::size_t i) { return int((i * 37 + 11) % SIZE); }
+
+template <std::size_t... Is>
+Typelist<CTValue<int, shuffled(Is)>...> makeList(std::index_sequence<Is...>);
+template <std::size_t... Is>
+Typelist<CTValue<int, int(SIZE - 1 - Is)>...>
+makeExpected(std::index_sequence<Is...>);
+
+using List = decltype(makeList(std::make_index_sequence<SIZE>()));
+using Expected = decltype(makeExpected(std::make_index_sequence<SIZE>()));
+
+#if defined(VALUES)
+template <std::size_t... Is>
+Valuelist<int, shuffled(Is)...> makeValues(std::index_sequence<Is...>);
+template <std::size_t... Is>
+Valuelist<int, int(SIZE - 1 - Is)...>
+makeExpectedValues(std::index_sequence<Is...>);
+
+static_assert(
+    std::is_same_v<
+        SortValues<decltype(makeValues(std::make_index_sequence<SIZE>())),
+                   std::greater<>>,
+        decltype(makeExpectedValues(std::make_index_sequence<SIZE>()))>);
+#elif defined(INSERTION)
+static_assert(std::is_same_v<InsertionSort<List, GreaterThanT>, Expected>);
+#else
+static_assert(std::is_same_v<MergeSort<List, GreaterThanT>, Expected>);
+#endif
+
+int main() {}
@@ -0,0 +1,237 @@
+#pragma once
+#include "type_list.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// 运行时类型分派
+// 把 Typelist<Types...> 变成一张分派表：给定序列化的类型编号，
+// 经过编译期求出的完美哈希找到槽位（查两次表），再通过函数指针表直接调用
+// 为对应类型实例化的处理函数，不再需要按编号逐个比较的 if/else 链。
+
+// 类型标签：把类型作为值传给处理函数
+template <typename T> struct TypeTag {
+  using Type = T;
+};
+
+// 类型的序列化编号，默认取 T::typeId，也可以为第三方类型特化
+template <typename T> struct TypeIdT {
+  static constexpr std::uint32_t value = T::typeId;
+};
+
+class UnknownTypeId : public std::out_of_range {
+public:
+  explicit UnknownTypeId(std::uint32_t id)
+      : std::out_of_range("unknown type id: " + std::to_string(id)) {}
+};
+
+template <typename List> class TypeDispatcher;
+
+template <typename... Types> class TypeDispatcher<Typelist<Types...>> {
+  static constexpr std::size_t count = sizeof...(Types);
+  static_assert(count > 0, "dispatch list must not be empty");
+  static constexpr std::array<std::uint32_t, count> ids = {
+      TypeIdT<Types>::value...};
+
+  // 槽位数取不小于 2 * count 的 2 的幂，桶数为槽位数的一半
+  static constexpr unsigned bits = [] {
+    unsigned b = 1;
+    while ((std::size_t(1) << b) < 2 * count) {
+      ++b;
+    }
+    return b;
+  }();
+  static constexpr std::size_t slotCount = std::size_t(1) << bits;
+  static constexpr std::size_t bucketCount = slotCount / 2;
+
+  static constexpr std::uint64_t mix(std::uint32_t id, std::uint32_t seed) {
+    std::uint64_t h = id ^ (seed * 0x9e3779b97f4a7c15ull);
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 29;
+    return h;
+  }
+  static constexpr std::size_t bucketOf(std::uint32_t id) {
+    return std::size_t(mix(id, 0) & (bucketCount - 1));
+  }
+  static constexpr std::size_t slotOf(std::uint32_t id, std::uint32_t seed) {
+    return std::size_t(mix(id, seed) >> (64 - bits));
+  }
+
+  // 编译期的完美哈希（hash and displace）：编号先按 bucketOf 分桶，
+  // 再从最大的桶开始为每个桶寻找一个种子，使桶内编号都落在空槽位上。
+  // seeds 为每个桶的种子，slots 为槽位 -> 在 Types 中的下标（空槽位为 count）。
+  // 相同的编号一定落在同一个桶里，找不到种子，因此先在桶内检查重复。
+  struct Layout {
+    std::array<std::uint32_t, bucketCount> seeds{};
+    std::array<std::uint32_t, slotCount> slots{};
+    bool distinct = true;
+  };
+  static constexpr Layout layout = [] {
+    Layout result;
+    for (auto &index : result.slots) {
+      index = count;
+    }
+    // 按桶排列编号的下标：桶 b 的成员为 members[offsets[b], offsets[b + 1])
+    std::array<std::size_t, bucketCount + 1> offsets{};
+    for (std::size_t i = 0; i != count; ++i) {
+      ++offsets[bucketOf(ids[i]) + 1];
+    }
+    std::size_t largest = 0;
+    for (std::size_t b = 0; b != bucketCount; ++b) {
+      largest = offsets[b + 1] > largest ? offsets[b + 1] : largest;
+      offsets[b + 1] += offsets[b];
+    }
+    std::array<std::size_t, count> members{};
+    std::array<std::size_t, bucketCount> filled{};
+    for (std::size_t i = 0; i != count; ++i) {
+      std::size_t b = bucketOf(ids[i]);
+      members[offsets[b] + filled[b]++] = i;
+    }
+    for (std::size_t b = 0; b != bucketCount; ++b) {
+      for (std::size_t k = offsets[b]; k != offsets[b + 1]; ++k) {
+        for (std::size_t j = offsets[b]; j != k; ++j) {
+          if (ids[members[j]] == ids[members[k]]) {
+            result.distinct = false;
+            return result;
+          }
+        }
+      }
+    }
+
+    std::array<std::size_t, count> taken{};
+    for (std::size_t size = largest; size != 0; --size) {
+      for (std::size_t b = 0; b != bucketCount; ++b) {
+        if (offsets[b + 1] - offsets[b] != size) {
+          continue;
+        }
+        for (std::uint32_t seed = 1;; ++seed) {
+          bool ok = true;
+          for (std::size_t k = 0; k != size && ok; ++k) {
+            std::size_t slot = slotOf(ids[members[offsets[b] + k]], seed);
+            ok = result.slots[slot] == count;
+            for (std::size_t j = 0; j != k && ok; ++j) {
+              ok = taken[j] != slot;
+            }
+            taken[k] = slot;
+          }
+          if (ok) {
+            result.seeds[b] = seed;
+            for (std::size_t k = 0; k != size; ++k) {
+              result.slots[taken[k]] = std::uint32_t(members[offsets[b] + k]);
+            }
+            break;
+          }
+        }
+      }
+    }
+    return result;
+  }();
+  static_assert(layout.distinct, "duplicate type ids in dispatch list");
+
+  // 各处理函数返回类型相同时直接使用它，避免对很长的列表递归求 common_type
+  template <typename First, typename... Rest> struct CommonResultT {
+    using Type = typename std::conditional_t<
+        (std::is_same_v<First, Rest> && ...), std::type_identity<First>,
+        std::common_type<First, Rest...>>::type;
+  };
+
+  template <typename Handler, typename... Args>
+  using Result = typename CommonResultT<decltype(std::declval<Handler>()(
+      TypeTag<Types>{}, std::declval<Args>()...))...>::Type;
+
+  template <typename R, typename T, typename Handler, typename... Args>
+  static R invoke(Handler &&handler, Args &&...args) {
+    return static_cast<R>(std::forward<Handler>(handler)(
+        TypeTag<T>{}, std::forward<Args>(args)...));
+  }
+
+public:
+  static constexpr std::size_t size() { return count; }
+
+  // 编号对应的类型在 Types 中的下标，未知编号返回 -1
+  static constexpr std::int64_t indexOf(std::uint32_t id) {
+    std::uint32_t index =
+        layout.slots[slotOf(id, layout.seeds[bucketOf(id)])];
+    return index != count && ids[index] == id ? std::int64_t(index) : -1;
+  }
+
+  // 类型标签在编译期就确定了下标
+  template <typename T> static constexpr std::size_t indexOf(TypeTag<T>) {
+    constexpr std::size_t index = [] {
+      constexpr bool same[] = {std::is_same_v<T, Types>...};
+      std::size_t i = 0;
+      while (i != count && !same[i]) {
+        ++i;
+      }
+      return i;
+    }();
+    static_assert(index != count, "type is not in the dispatch list");
+    return index;
+  }
+
+  // 以 handler(TypeTag<T>{}, args...) 调用编号对应的 T 的处理函数，
+  // 返回各处理函数返回类型的公共类型；未知编号抛出 UnknownTypeId
+  template <typename Handler, typename... Args>
+  static Result<Handler, Args...> dispatch(std::uint32_t id, Handler &&handler,
+                                           Args &&...args) {
+    using R = Result<Handler, Args...>;
+    using Thunk = R (*)(Handler &&, Args &&...);
+    static constexpr Thunk table[] = {&invoke<R, Types, Handler, Args...>...};
+    std::int64_t index = indexOf(id);
+    if (index < 0) {
+      throw UnknownTypeId(id);
+    }
+    return table[index](std::forward<Handler>(handler),
+                        std::forward<Args>(args)...);
+  }
+};
+
+struct Heartbeat {
+  static constexpr std::uint32_t typeId = 7;
+};
+struct Quote {
+  static constexpr std::uint32_t typeId = 1042;
+  double price = 0;
+};
+struct Trade {
+  static constexpr std::uint32_t typeId = 0xdead;
+  int quantity = 0;
+};
+
+struct Decode {
+  std::size_t operator()(TypeTag<Heartbeat>, char const *) const { return 0; }
+  std::size_t operator()(TypeTag<Quote>, char const *) const {
+    return sizeof(Quote);
+  }
+  std::size_t operator()(TypeTag<Trade>, char const *) const {
+    return sizeof(Trade);
+  }
+};
+
+void test_type_dispatch() {
+  using Messages = TypeDispatcher<Typelist<Heartbeat, Quote, Trade>>;
+  static_assert(Messages::indexOf(7) == 0);
+  static_assert(Messages::indexOf(1042) == 1);
+  static_assert(Messages::indexOf(0xdead) == 2);
+  static_assert(Messages::indexOf(8) == -1);
+  static_assert(Messages::indexOf(TypeTag<Trade>{}) == 2);
+
+  char const buffer[16] = {};
+  std::cout << Messages::dispatch(1042, Decode{}, buffer) << ' '
+            << Messages::dispatch(0xdead, Decode{}, buffer) << ' ';
+  // 泛型处理函数为每个类型各实例化一次
+  Messages::dispatch(7, [](auto tag) {
+    std::cout << TypeIdT<typename decltype(tag)::Type>::value << '\n';
+  });
+  try {
+    Messages::dispatch(8, Decode{}, buffer);
+  } catch (UnknownTypeId const &e) {
+    std::cout << e.what() << '\n';
+  }
+}
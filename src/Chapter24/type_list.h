@@ -1,6 +1,7 @@
 #pragma once
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 template <typename... Elements> class Typelist {};
 
 template <typename List> class FrontT {
@@ -37,9 +38,56 @@ template <typename List, typename NewElement>
 using PushFront = typename PushFrontT<List, NewElement>::Type;
 
 // Indexing
+// 书中的递归实现：取第 N 个元素需要实例化 N 个类，循环索引整个列表是平方级的
 template <typename List, std::size_t N>
-class NthElementT : public NthElementT<PopFront<List>, N - 1> {};
-template <typename List> class NthElementT<List, 0> : public FrontT<List> {};
+class NthElementRecursiveT : public NthElementRecursiveT<PopFront<List>, N - 1> {
+};
+template <typename List>
+class NthElementRecursiveT<List, 0> : public FrontT<List> {};
+
+// 常数深度的包索引：有编译器内建的 __type_pack_element 时直接使用，否则把
+// 每个元素和它的下标绑定为一个基类，通过重载决议一次选出第 N 个。
+// 对同一个包，IndexedTypes 只实例化一次，之后每次索引都是 O(1) 深度。
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define TYPELIST_HAS_TYPE_PACK_ELEMENT 1
+#endif
+#endif
+
+#ifdef TYPELIST_HAS_TYPE_PACK_ELEMENT
+template <std::size_t N, typename... Elements> class PackElementT {
+public:
+  using Type = __type_pack_element<N, Elements...>;
+};
+#else
+template <std::size_t I, typename T> struct IndexedType {
+  using Type = T;
+};
+
+template <typename Indices, typename... Elements> struct IndexedTypes;
+template <std::size_t... Is, typename... Elements>
+struct IndexedTypes<std::index_sequence<Is...>, Elements...>
+    : IndexedType<Is, Elements>... {};
+
+template <std::size_t I, typename T>
+IndexedType<I, T> selectIndexed(IndexedType<I, T> const &);
+
+template <std::size_t N, typename... Elements> class PackElementT {
+  static_assert(N < sizeof...(Elements), "typelist index out of range");
+
+public:
+  using Type = typename decltype(selectIndexed<N>(
+      std::declval<IndexedTypes<std::index_sequence_for<Elements...>,
+                                Elements...>>()))::Type;
+};
+#endif
+
+// 一般的列表仍按 PopFront 递归，Typelist 使用常数深度的实现
+template <typename List, std::size_t N>
+class NthElementT : public NthElementRecursiveT<List, N> {};
+template <typename... Elements, std::size_t N>
+class NthElementT<Typelist<Elements...>, N>
+    : public PackElementT<N, Elements...> {};
 
 template <typename List, unsigned N>
 using NthElement = typename NthElementT<List, N>::Type;
@@ -237,6 +285,225 @@ public:
   using Type = List;
 };
 
+// Merge Sort
+// 插入排序需要 O(N^2) 次实例化，归并排序只需要 O(N log N) 次。
+// 只依赖 Front/PopFront/PushFront/IsEmpty 接口，和插入排序一样适用于
+// Typelist、Valuelist 以及 Cons 列表，Compare 的用法也相同。
+
+// SplitT 把 List 从中间切开：Fast 每次前进两个元素，List 每次前进一个，
+// Fast 走到末尾时 List 剩下的就是后半段。Fast 为空（或只剩一个元素）时
+// 它本身（或它的 PopFront）正好是一个同类型的空列表，用作前半段的起点。
+template <typename List, typename Fast, bool = IsEmpty<Fast>::value>
+class SplitT;
+template <typename List, typename Fast, bool = IsEmpty<PopFront<Fast>>::value>
+class SplitNonEmptyT;
+
+template <typename List, typename Fast> class SplitT<List, Fast, true> {
+public:
+  using Left = Fast;
+  using Right = List;
+};
+template <typename List, typename Fast>
+class SplitT<List, Fast, false> : public SplitNonEmptyT<List, Fast> {};
+
+template <typename List, typename Fast>
+class SplitNonEmptyT<List, Fast, true> {
+public:
+  using Left = PopFront<Fast>;
+  using Right = List;
+};
+template <typename List, typename Fast>
+class SplitNonEmptyT<List, Fast, false> {
+  using Rest = SplitT<PopFront<List>, PopFront<PopFront<Fast>>>;
+
+public:
+  using Left = PushFront<typename Rest::Left, Front<List>>;
+  using Right = typename Rest::Right;
+};
+
+// MergeT 合并两个已排序的列表。只有 Compare<后者, 前者> 成立时才先取
+// List2 的元素，所以排序是稳定的。
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare,
+          bool = IsEmpty<List1>::value, bool = IsEmpty<List2>::value>
+class MergeT;
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare>
+using Merge = typename MergeT<List1, List2, Compare>::Type;
+
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare, bool TakeSecond>
+class MergeStepT;
+
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare, bool Empty2>
+class MergeT<List1, List2, Compare, true, Empty2> {
+public:
+  using Type = List2;
+};
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare>
+class MergeT<List1, List2, Compare, false, true> {
+public:
+  using Type = List1;
+};
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare>
+class MergeT<List1, List2, Compare, false, false>
+    : public MergeStepT<List1, List2, Compare,
+                        Compare<Front<List2>, Front<List1>>::value> {};
+
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare>
+class MergeStepT<List1, List2, Compare, true>
+    : public PushFrontT<Merge<List1, PopFront<List2>, Compare>,
+                        Front<List2>> {};
+template <typename List1, typename List2,
+          template <typename T, typename U> class Compare>
+class MergeStepT<List1, List2, Compare, false>
+    : public PushFrontT<Merge<PopFront<List1>, List2, Compare>,
+                        Front<List1>> {};
+
+// 长度为 0 或 1 的列表已经有序
+template <typename List, template <typename T, typename U> class Compare,
+          bool = IsEmpty<List>::value>
+class MergeSortT;
+template <typename List, template <typename T, typename U> class Compare,
+          bool = IsEmpty<PopFront<List>>::value>
+class MergeSortNonEmptyT;
+
+template <typename List, template <typename T, typename U> class Compare>
+using MergeSort = typename MergeSortT<List, Compare>::Type;
+
+template <typename List, template <typename T, typename U> class Compare>
+class MergeSortT<List, Compare, true> {
+public:
+  using Type = List;
+};
+template <typename List, template <typename T, typename U> class Compare>
+class MergeSortT<List, Compare, false>
+    : public MergeSortNonEmptyT<List, Compare> {};
+
+template <typename List, template <typename T, typename U> class Compare>
+class MergeSortNonEmptyT<List, Compare, true> {
+public:
+  using Type = List;
+};
+template <typename List, template <typename T, typename U> class Compare>
+class MergeSortNonEmptyT<List, Compare, false> {
+  using Halves = SplitT<List, List>;
+
+public:
+  using Type = Merge<MergeSort<typename Halves::Left, Compare>,
+                     MergeSort<typename Halves::Right, Compare>, Compare>;
+};
+
+// 上面的 SplitT 和 MergeT 每处理一个元素就多嵌套一层实例化，深度随长度线性
+// 增长，512 个元素就会超出默认的实例化深度。Typelist 可以按下标直接取出
+// 任意一段，因此另有对数深度的实现：按下标对半切分；合并时取第一个列表
+// 中间的元素，二分查找它在第二个列表中的位置，把问题切成互不相关的两半。
+
+// 下标在 [Begin, End) 内的元素
+template <typename List, std::size_t Begin, std::size_t End> class SliceT;
+template <typename... Elements, std::size_t Begin, std::size_t End>
+class SliceT<Typelist<Elements...>, Begin, End> {
+  template <std::size_t... Is>
+  static Typelist<typename PackElementT<Begin + Is, Elements...>::Type...>
+      select(std::index_sequence<Is...>);
+
+public:
+  using Type = decltype(select(std::make_index_sequence<End - Begin>()));
+};
+template <typename List, std::size_t Begin, std::size_t End>
+using Slice = typename SliceT<List, Begin, End>::Type;
+
+template <typename List1, typename List2> class ConcatT;
+template <typename... Elements1, typename... Elements2>
+class ConcatT<Typelist<Elements1...>, Typelist<Elements2...>> {
+public:
+  using Type = Typelist<Elements1..., Elements2...>;
+};
+
+// List 的 [Lo, Hi) 中第一个不满足 Compare<元素, T> 的下标，Compare 对该区间
+// 必须是先真后假的
+template <typename List, typename T,
+          template <typename T1, typename U> class Compare, std::size_t Lo,
+          std::size_t Hi, bool = (Lo == Hi)>
+class LowerBoundT {
+public:
+  static constexpr std::size_t value = Lo;
+};
+template <typename List, typename T,
+          template <typename T1, typename U> class Compare, std::size_t Lo,
+          std::size_t Hi>
+class LowerBoundT<List, T, Compare, Lo, Hi, false> {
+  static constexpr std::size_t Mid = Lo + (Hi - Lo) / 2;
+
+public:
+  // std::conditional_t 只命名两个分支，只有选中的分支被实例化
+  static constexpr std::size_t value = std::conditional_t<
+      Compare<NthElement<List, Mid>, T>::value,
+      LowerBoundT<List, T, Compare, Mid + 1, Hi>,
+      LowerBoundT<List, T, Compare, Lo, Mid>>::value;
+};
+
+// 合并 List1 的 [B1, E1) 和 List2 的 [B2, E2)。List1 中间的元素 Pivot 之前
+// 放 List2 中严格小于它的元素，相等的元素留在它之后，所以排序仍是稳定的。
+template <typename List1, std::size_t B1, std::size_t E1, typename List2,
+          std::size_t B2, std::size_t E2,
+          template <typename T, typename U> class Compare,
+          int = B1 == E1 ? 0 : B2 == E2 ? 1 : 2>
+class MergeRangeT;
+template <typename List1, std::size_t B1, std::size_t E1, typename List2,
+          std::size_t B2, std::size_t E2,
+          template <typename T, typename U> class Compare>
+class MergeRangeT<List1, B1, E1, List2, B2, E2, Compare, 0>
+    : public SliceT<List2, B2, E2> {};
+template <typename List1, std::size_t B1, std::size_t E1, typename List2,
+          std::size_t B2, std::size_t E2,
+          template <typename T, typename U> class Compare>
+class MergeRangeT<List1, B1, E1, List2, B2, E2, Compare, 1>
+    : public SliceT<List1, B1, E1> {};
+template <typename List1, std::size_t B1, std::size_t E1, typename List2,
+          std::size_t B2, std::size_t E2,
+          template <typename T, typename U> class Compare>
+class MergeRangeT<List1, B1, E1, List2, B2, E2, Compare, 2> {
+  static constexpr std::size_t Mid = B1 + (E1 - B1) / 2;
+  using Pivot = NthElement<List1, Mid>;
+  static constexpr std::size_t Split =
+      LowerBoundT<List2, Pivot, Compare, B2, E2>::value;
+
+public:
+  using Type = typename ConcatT<
+      typename MergeRangeT<List1, B1, Mid, List2, B2, Split, Compare>::Type,
+      PushFront<typename MergeRangeT<List1, Mid + 1, E1, List2, Split, E2,
+                                     Compare>::Type,
+                Pivot>>::Type;
+};
+
+template <typename... Elements1, typename... Elements2,
+          template <typename T, typename U> class Compare>
+class MergeT<Typelist<Elements1...>, Typelist<Elements2...>, Compare, false,
+             false>
+    : public MergeRangeT<Typelist<Elements1...>, 0, sizeof...(Elements1),
+                         Typelist<Elements2...>, 0, sizeof...(Elements2),
+                         Compare> {};
+
+template <typename Element, template <typename T, typename U> class Compare>
+class MergeSortT<Typelist<Element>, Compare, false> {
+public:
+  using Type = Typelist<Element>;
+};
+template <typename... Elements, template <typename T, typename U> class Compare>
+class MergeSortT<Typelist<Elements...>, Compare, false> {
+  static constexpr std::size_t Size = sizeof...(Elements);
+  using List = Typelist<Elements...>;
+
+public:
+  using Type = Merge<MergeSort<Slice<List, 0, Size / 2>, Compare>,
+                     MergeSort<Slice<List, Size / 2, Size>, Compare>, Compare>;
+};
+
 template <typename T, typename U> struct SmallerThanT {
   constexpr static bool value = sizeof(T) < sizeof(U);
 };
@@ -261,4 +528,9 @@ void test() {
   static_assert(
       std::is_same_v<InsertionSort<Typelist<int, char, double>, SmallerThanT>,
                      Typelist<char, int, double>>);
+  static_assert(std::is_same_v<MergeSort<Typelist<>, SmallerThanT>, Typelist<>>);
+  static_assert(
+      std::is_same_v<MergeSort<Typelist<double, int, char, short, float>,
+                               SmallerThanT>,
+                     Typelist<char, short, int, float, double>>);
 }
@@ -0,0 +1,30 @@
+// Typelist 基本算法的编译期开销：生成 SIZE 个不同类型组成的 Typelist，
+// 用 REVERSE、TRANSFORM 或 ACCUMULATE 选择要测的算法（InsertionSort 见
+// sort_bench.cc）。
+// 只需要编译（-fsyntax-only），见 CMakeLists.txt 中的 compile-bench。
+#include "type_list.h"
+#include <utility>
+
+#ifndef SIZE
+#define SIZE 64
+#endif
+
+// 大小为 1..16 字节的不同类型
+template <std::size_t I> struct Tag {
+  char data[I % 16 + 1];
+};
+
+template <std::size_t... Is>
+Typelist<Tag<Is>...> makeTagList(std::index_sequence<Is...>);
+
+using List = decltype(makeTagList(std::make_index_sequence<SIZE>()));
+
+#if defined(REVERSE)
+static_assert(std::is_same_v<Front<Reverse<List>>, Tag<SIZE - 1>>);
+#elif defined(TRANSFORM)
+static_assert(std::is_same_v<Front<Transform<List, AddConst>>, Tag<0> const>);
+#elif defined(ACCUMULATE)
+static_assert(sizeof(Accumulate<List, LargerTypeT, char>) == 16);
+#endif
+
+int main() {}
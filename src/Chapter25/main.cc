@@ -1,6 +1,23 @@
 #include "tuple"
+#include "parallel_apply.h"
 #include "tuple.h"
+#include <stdexcept>
 #include <string>
+#include <cctype>
+#include <unordered_map>
+
+// 忽略大小写比较的字符：没有 padding，但不能按字节哈希
+struct CaseInsensitiveChar {
+  char c;
+  bool operator==(CaseInsensitiveChar other) const {
+    return std::tolower(c) == std::tolower(other.c);
+  }
+};
+template <> struct std::hash<CaseInsensitiveChar> {
+  std::size_t operator()(CaseInsensitiveChar x) const {
+    return std::hash<int>{}(std::tolower(x.c));
+  }
+};
 
 int main() {
   Tuple<int, double, std::string> t(1, 2.0, "3");
@@ -28,4 +45,52 @@ int main() {
   auto b = tt[CTValue<unsigned, 3>{}];
 
   std::cout << a << " " << b << std::endl;
+
+  // 右值 Tuple 的 get 返回值，绑定到 const 引用时延长的是这个值的生命期
+  auto const &moved = get<1>(makeTuple(1, std::string{"temporary"}));
+  std::cout << moved << std::endl;
+
+  // Apply & parallel apply
+  // std::apply 会通过 ADL 被找到（std::string 作为模板实参），因此显式限定
+  std::cout << ::apply([](int x, char c, float f,
+                        std::string const &s) { return x + c + f + s.size(); },
+                     tt)
+            << std::endl;
+
+  auto stages = makeTuple(21, 1.5, std::string{"stage"});
+  auto results = parallelApply(
+      [](auto const &elem) { return elem + elem; }, stages);
+  std::cout << results << std::endl;
+
+  forEachParallel(stages, [](auto &elem) { elem = elem + elem; });
+  std::cout << (stages == results) << std::endl;
+
+  // 指定线程池和块大小：两个元素一块，三个元素只产生两个任务
+  ThreadPool pool(2);
+  auto doubled = parallelApply(
+      pool, [](auto const &elem) { return elem + elem; }, stages, 2);
+  std::cout << doubled << std::endl;
+  try {
+    forEachParallel(pool, stages, [](auto &) { throw std::runtime_error("x"); });
+  } catch (std::runtime_error const &) {
+    std::cout << "forEachParallel rethrows" << std::endl;
+  }
+
+  // Tuple as key
+  std::unordered_map<Tuple<int, char, std::string>, int> counts;
+  ++counts[makeTuple(1, 'a', std::string{"x"})];
+  ++counts[makeTuple(1, 'a', std::string{"x"})];
+  ++counts[makeTuple(2, 'a', std::string{"x"})];
+  std::cout << counts.size() << " "
+            << counts[makeTuple(1, 'a', std::string{"x"})] << std::endl;
+
+  // 相等的键必须有相同的哈希值
+  std::unordered_map<Tuple<CaseInsensitiveChar, int>, int> letters;
+  ++letters[makeTuple(CaseInsensitiveChar{'a'}, 1)];
+  ++letters[makeTuple(CaseInsensitiveChar{'A'}, 1)];
+  std::cout << letters.size() << std::endl;
+
+  std::cout << (makeTuple(1, 2.5) < makeTuple(1, 3.5)) << " "
+            << (makeTuple(2, std::string{"a"}) >= makeTuple(1, std::string{"b"}))
+            << std::endl;
 }
@@ -0,0 +1,91 @@
+#pragma once
+#include "../Chapter22/function_ptr/thread_pool.h"
+#include "tuple.h"
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+// Parallel apply
+// 与 apply() 一样使用 index list 展开 tuple，但不是把所有元素作为一次调用的
+// 参数，而是对每个元素单独调用 f，并且这些调用彼此并发执行。
+// 调用在 Chapter22 的工作窃取线程池上执行：元素按 grain 个一组分块，每块是
+// 一个任务，调用线程也参与执行，不会为每个元素创建线程。grain 为 0 时按线程
+// 数均分。元素调用抛出的异常在全部调用结束后重新抛出（第一个）。
+// 不传线程池时使用 ThreadPool::shared()。
+
+// 各块共享的状态；Results 为 Tuple<> 时丢弃返回值
+template <typename F, typename T, typename Results> struct ParallelApplyContext {
+  F const &f;
+  T &t;
+  Results results;
+
+  template <unsigned I> static void call(ParallelApplyContext &context) {
+    if constexpr (std::is_same_v<Results, Tuple<>>) {
+      context.f(get<I>(context.t));
+    } else {
+      get<I>(context.results).emplace(context.f(get<I>(context.t)));
+    }
+  }
+};
+
+// 运行期下标到元素调用的跳转表，每块只需一次间接调用就能找到元素
+template <typename Context, unsigned... Indices>
+void parallelApplyRun(ThreadPool &pool, Context &context, std::size_t grain,
+                      Valuelist<unsigned, Indices...>) {
+  constexpr std::size_t N = sizeof...(Indices);
+  if constexpr (N != 0) {
+    using Call = void (*)(Context &);
+    static constexpr Call calls[] = {&Context::template call<Indices>...};
+    if (grain == 0) {
+      grain = (N + pool.size() - 1) / pool.size();
+    }
+    // parallelFor 等所有块结束后重新抛出第一个异常
+    pool.parallelFor(0, N, grain,
+                     [&context](std::size_t i) { calls[i](context); });
+  }
+}
+
+template <typename F, typename... Elements, unsigned... Indices>
+auto parallelApplyImpl(ThreadPool &pool, F const &f,
+                       Tuple<Elements...> const &t, std::size_t grain,
+                       Valuelist<unsigned, Indices...> indices) {
+  constexpr bool hasResults =
+      (!std::is_void_v<decltype(f(get<Indices>(t)))> && ...);
+  static_assert(hasResults,
+                "parallelApply needs a result for every element; use "
+                "forEachParallel for callables that return void");
+  if constexpr (hasResults) {
+    using Result = Tuple<std::decay_t<decltype(f(get<Indices>(t)))>...>;
+    // 结果类型不一定能默认构造，先放在 optional 中
+    using Slots =
+        Tuple<std::optional<std::decay_t<decltype(f(get<Indices>(t)))>>...>;
+    ParallelApplyContext<F, Tuple<Elements...> const, Slots> context{f, t, {}};
+    parallelApplyRun(pool, context, grain, indices);
+    return Result(std::move(*get<Indices>(context.results))...);
+  }
+}
+
+// 返回 Tuple<R0, R1, ...>，其中 Ri 为 f(get<i>(t)) 的（decay 后）结果类型
+template <typename F, typename... Elements>
+auto parallelApply(ThreadPool &pool, F const &f, Tuple<Elements...> const &t,
+                   std::size_t grain = 0) {
+  return parallelApplyImpl(pool, f, t, grain,
+                           MakeIndexList<sizeof...(Elements)>());
+}
+template <typename F, typename... Elements>
+auto parallelApply(F const &f, Tuple<Elements...> const &t) {
+  return parallelApply(ThreadPool::shared(), f, t);
+}
+
+// 对每个元素并发地调用 f（允许修改元素），丢弃返回值，等待全部完成后返回
+template <typename F, typename... Elements>
+void forEachParallel(ThreadPool &pool, Tuple<Elements...> &t, F const &f,
+                     std::size_t grain = 0) {
+  ParallelApplyContext<F, Tuple<Elements...>, Tuple<>> context{f, t, {}};
+  parallelApplyRun(pool, context, grain,
+                   MakeIndexList<sizeof...(Elements)>());
+}
+template <typename F, typename... Elements>
+void forEachParallel(Tuple<Elements...> &t, F const &f) {
+  forEachParallel(ThreadPool::shared(), t, f);
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <type_traits>
 #include <utility>
@@ -46,22 +50,41 @@ public:
 
 template <> class Tuple<> {};
 
-// 获取元素
+// 获取元素（返回引用，避免每次 get 都拷贝一次元素）
 template <unsigned N> struct TupleGet {
   template <typename Head, typename... Tail>
-  static auto apply(Tuple<Head, Tail...> const &t) {
+  static auto const &apply(Tuple<Head, Tail...> const &t) {
+    return TupleGet<N - 1>::apply(t.getTail());
+  }
+  template <typename Head, typename... Tail>
+  static auto &apply(Tuple<Head, Tail...> &t) {
     return TupleGet<N - 1>::apply(t.getTail());
   }
 };
 
 template <> struct TupleGet<0> {
   template <typename Head, typename... Tail>
-  static auto apply(Tuple<Head, Tail...> const &t) {
+  static Head const &apply(Tuple<Head, Tail...> const &t) {
+    return t.getHead();
+  }
+  template <typename Head, typename... Tail>
+  static Head &apply(Tuple<Head, Tail...> &t) {
     return t.getHead();
   }
 };
 
-template <unsigned N, typename... Types> auto get(Tuple<Types...> const &t) {
+template <unsigned N, typename... Types>
+auto const &get(Tuple<Types...> const &t) {
+  return TupleGet<N>::apply(t);
+}
+template <unsigned N, typename... Types> auto &get(Tuple<Types...> &t) {
+  return TupleGet<N>::apply(t);
+}
+// 右值 Tuple 返回元素的值（从中移动），引用不会比临时的 Tuple 活得更久
+template <unsigned N, typename... Types> auto get(Tuple<Types...> &&t) {
+  return std::move(TupleGet<N>::apply(t));
+}
+template <unsigned N, typename... Types> auto get(Tuple<Types...> const &&t) {
   return TupleGet<N>::apply(t);
 }
 
@@ -72,10 +95,143 @@ template <typename... Types> auto makeTuple(Types &&...elems) {
 // Compare Tuple
 bool operator==(Tuple<>, Tuple<>) { return true; }
 template <typename Head1, typename... Tail1, typename Head2, typename... Tail2>
-bool operator==(Tuple<Head1, Tail1...> t1, Tuple<Head2, Tail2...> t2) {
+bool operator==(Tuple<Head1, Tail1...> const &t1,
+                Tuple<Head2, Tail2...> const &t2) {
   return t1.getHead() == t2.getHead() && t1.getTail() == t2.getTail();
 }
 
+// 三路比较：按字典序逐个比较元素，遇到第一个不相等的元素就返回。
+// 元素类型若没有 <=>，则退化为用 < 合成 weak_ordering。
+template <typename T, typename U> auto synthThreeWay(T const &t, U const &u) {
+  if constexpr (std::three_way_comparable_with<T, U>) {
+    return t <=> u;
+  } else {
+    if (t < u)
+      return std::weak_ordering::less;
+    if (u < t)
+      return std::weak_ordering::greater;
+    return std::weak_ordering::equivalent;
+  }
+}
+
+template <typename T, typename U>
+using SynthThreeWayResult =
+    decltype(synthThreeWay(std::declval<T const &>(), std::declval<U const &>()));
+
+inline std::strong_ordering operator<=>(Tuple<> const &, Tuple<> const &) {
+  return std::strong_ordering::equal;
+}
+template <typename Head1, typename... Tail1, typename Head2, typename... Tail2>
+auto operator<=>(Tuple<Head1, Tail1...> const &t1,
+                 Tuple<Head2, Tail2...> const &t2)
+    -> std::common_comparison_category_t<
+        SynthThreeWayResult<Head1, Head2>,
+        decltype(t1.getTail() <=> t2.getTail())> {
+  if (auto cmp = synthThreeWay(t1.getHead(), t2.getHead()); cmp != 0) {
+    return cmp;
+  }
+  return t1.getTail() <=> t2.getTail();
+}
+
+// Hash Tuple
+// TupleHasher 把元素当作一个字节流来处理：整数、枚举和指针这类相等即逐字节
+// 相等的元素直接把对象表示写入流中，因此相邻的这类元素会连成一段按 8 字节
+// 分块哈希的字节块；其余元素先用 std::hash 求值，再把结果写入流中。
+// 类类型即使没有 padding，也可能有自己的 operator==（比如忽略大小写），
+// 不能按字节哈希，除非通过特化 IsByteHashable 明确声明。
+class TupleHasher {
+  std::uint64_t state = 0x9e3779b97f4a7c15ull;
+  std::uint64_t pending = 0; // 尚未凑满 8 字节的部分
+  unsigned pendingBytes = 0;
+  std::uint64_t length = 0;
+
+  static std::uint64_t mix(std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+    std::uint64_t r = a * b;
+    return r ^ (r >> 32);
+#endif
+  }
+  void block(std::uint64_t word) {
+    state = mix(state ^ word, 0xbf58476d1ce4e5b9ull);
+  }
+
+public:
+  void update(void const *data, std::size_t len) {
+    auto p = static_cast<unsigned char const *>(data);
+    length += len;
+    // 先补齐上一次留下的不完整块
+    while (pendingBytes != 0 && len != 0) {
+      pending |= std::uint64_t(*p++) << (8 * pendingBytes);
+      --len;
+      if (++pendingBytes == 8) {
+        block(pending);
+        pending = 0;
+        pendingBytes = 0;
+      }
+    }
+    for (; len >= 8; p += 8, len -= 8) {
+      std::uint64_t word;
+      std::memcpy(&word, p, 8);
+      block(word);
+    }
+    for (; len != 0; --len) {
+      pending |= std::uint64_t(*p++) << (8 * pendingBytes++);
+    }
+  }
+
+  std::size_t finish() const {
+    std::uint64_t h = state;
+    if (pendingBytes != 0) {
+      h = mix(h ^ pending, 0x94d049bb133111ebull);
+    }
+    // murmur3 fmix64
+    h ^= length;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+};
+
+// 可以按对象表示哈希的类型；其他类型特化为 true 时必须保证相等的值逐字节
+// 相等（std::has_unique_object_representations 且 == 逐成员比较）
+template <typename T>
+struct IsByteHashable
+    : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> ||
+                         std::is_pointer_v<T>> {};
+
+template <typename T> void hashAppend(TupleHasher &hasher, T const &value) {
+  if constexpr (IsByteHashable<T>::value) {
+    static_assert(std::has_unique_object_representations_v<T>,
+                  "IsByteHashable requires a unique object representation");
+    hasher.update(&value, sizeof(T));
+  } else {
+    static_assert(std::is_default_constructible_v<std::hash<T>>,
+                  "Tuple element needs a std::hash specialization");
+    std::size_t h = std::hash<T>{}(value);
+    hasher.update(&h, sizeof(h));
+  }
+}
+inline void hashAppend(TupleHasher &, Tuple<> const &) {}
+template <typename Head, typename... Tail>
+void hashAppend(TupleHasher &hasher, Tuple<Head, Tail...> const &t) {
+  hashAppend(hasher, t.getHead());
+  hashAppend(hasher, t.getTail());
+}
+
+template <typename... Types> struct std::hash<Tuple<Types...>> {
+  std::size_t operator()(Tuple<Types...> const &t) const {
+    TupleHasher hasher;
+    hashAppend(hasher, t);
+    return hasher.finish();
+  }
+};
+
 // Output Tuple
 #include <iostream>
 void printTuple(std::ostream &strm, Tuple<> const &, bool isFirst = true) {
@@ -167,6 +323,35 @@ auto reverse(Tuple<Head, Tail...> const &t) {
   return pushBack(reverse(t.getTail()), t.getHead());
 }
 
+// Index lists
+template <typename T, T... Values> struct Valuelist {};
+
+template <unsigned N, typename Result = Valuelist<unsigned>>
+struct MakeIndexListT;
+template <unsigned N, unsigned... Indices>
+struct MakeIndexListT<N, Valuelist<unsigned, Indices...>>
+    : MakeIndexListT<N - 1, Valuelist<unsigned, N - 1, Indices...>> {};
+template <unsigned... Indices>
+struct MakeIndexListT<0, Valuelist<unsigned, Indices...>> {
+  using Type = Valuelist<unsigned, Indices...>;
+};
+
+template <unsigned N> using MakeIndexList = typename MakeIndexListT<N>::Type;
+
+// Expanding tuples: 将 tuple 的元素展开为函数调用的参数
+template <typename F, typename... Elements, unsigned... Indices>
+auto applyImpl(F f, Tuple<Elements...> const &t,
+               Valuelist<unsigned, Indices...>)
+    -> decltype(f(get<Indices>(t)...)) {
+  return f(get<Indices>(t)...);
+}
+
+template <typename F, typename... Elements, unsigned N = sizeof...(Elements)>
+auto apply(F f, Tuple<Elements...> const &t)
+    -> decltype(applyImpl(f, t, MakeIndexList<N>())) {
+  return applyImpl(f, t, MakeIndexList<N>());
+}
+
 // void test() {
 //   // 测试 PopFront 的类型是否正确
 //   Tuple<int, double, std::string> t(1, 2.0, "3");
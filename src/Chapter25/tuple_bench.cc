@@ -0,0 +1,35 @@
+// Tuple 的编译期开销：生成 SIZE 个不同类型的元素组成的 Tuple，
+// 用 GET（构造并逐个读取）、REVERSE 或 COMPARE（<=>）选择要测的操作。
+// 只需要编译（-fsyntax-only），见 CMakeLists.txt 中的 compile-bench。
+#include "tuple.h"
+#include <cstddef>
+#include <utility>
+
+#ifndef SIZE
+#define SIZE 16
+#endif
+
+template <std::size_t I> struct Field {
+  int value;
+  auto operator<=>(Field const &) const = default;
+};
+
+template <std::size_t... Is> auto makeFields(std::index_sequence<Is...>) {
+  return makeTuple(Field<Is>{int(Is)}...);
+}
+
+template <typename T, std::size_t... Is>
+int sumFields(T const &t, std::index_sequence<Is...>) {
+  return (get<Is>(t).value + ... + 0);
+}
+
+int main() {
+  auto t = makeFields(std::make_index_sequence<SIZE>());
+#if defined(GET)
+  return sumFields(t, std::make_index_sequence<SIZE>());
+#elif defined(REVERSE)
+  return get<0>(reverse(t)).value;
+#elif defined(COMPARE)
+  return (t <=> t) == 0;
+#endif
+}
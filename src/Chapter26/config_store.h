@@ -0,0 +1,263 @@
+#pragma once
+#include "../Common/epoch.h"
+#include "varient.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 只读配置表
+// 加载时把所有键值冻结成一张扁平表：键通过最小完美哈希（hash and displace）
+// 映射到槽位，值按键的稳定编号存放在连续数组中。
+// handle<T>(key) 只需查一次完美哈希，之后快照上的 get(handle) 就是一次
+// 下标访问，返回表中值的引用。重新加载会构造新表并原子地替换当前表，
+// 读者从不加锁。
+//
+// 旧表按纪元回收（Common/epoch.h）：read() 得到的快照让当前线程进入读临界区，
+// 加载者替换表之后，等所有在替换之前进入的读者离开再释放旧表。旧表在之后的
+// 加载中回收。
+
+// 最小完美哈希：n 个键映射到 [0, n) 且互不冲突
+class PerfectHashIndex {
+  std::vector<std::uint32_t> seeds; // 每个桶的位移种子
+  std::vector<std::string> keys;    // 按槽位存放，用于确认命中
+  std::vector<std::uint32_t> ids;   // 槽位 -> 键的稳定编号
+
+  static std::uint64_t baseHash(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+  }
+  static std::uint64_t mix(std::uint64_t h, std::uint32_t seed) {
+    h ^= seed * 0x9e3779b97f4a7c15ull;
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 29;
+    return h;
+  }
+
+public:
+  PerfectHashIndex() = default;
+  PerfectHashIndex(
+      std::vector<std::pair<std::string, std::uint32_t>> const &entries) {
+    std::size_t n = entries.size();
+    if (n == 0) {
+      return;
+    }
+    seeds.assign(n, 0);
+    keys.resize(n);
+    ids.resize(n);
+
+    // 先按 seed 0 分桶，再从最大的桶开始为每个桶寻找不冲突的种子
+    std::vector<std::vector<std::size_t>> buckets(n);
+    for (std::size_t i = 0; i != n; ++i) {
+      buckets[mix(baseHash(entries[i].first), 0) % n].push_back(i);
+    }
+    std::vector<std::size_t> order(n);
+    for (std::size_t b = 0; b != n; ++b) {
+      order[b] = b;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> used(n, false);
+    std::vector<std::size_t> slots;
+    for (std::size_t b : order) {
+      auto const &bucket = buckets[b];
+      if (bucket.empty()) {
+        break;
+      }
+      for (std::uint32_t seed = 1;; ++seed) {
+        slots.clear();
+        for (std::size_t i : bucket) {
+          std::size_t slot = mix(baseHash(entries[i].first), seed) % n;
+          if (used[slot] ||
+              std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+            break;
+          }
+          slots.push_back(slot);
+        }
+        if (slots.size() == bucket.size()) {
+          seeds[b] = seed;
+          for (std::size_t k = 0; k != bucket.size(); ++k) {
+            used[slots[k]] = true;
+            keys[slots[k]] = entries[bucket[k]].first;
+            ids[slots[k]] = entries[bucket[k]].second;
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  // 返回键的稳定编号，不存在时返回 -1
+  std::int64_t find(std::string_view key) const {
+    std::size_t n = keys.size();
+    if (n == 0) {
+      return -1;
+    }
+    std::uint64_t h = baseHash(key);
+    std::size_t slot = mix(h, seeds[mix(h, 0) % n]) % n;
+    return keys[slot] == key ? std::int64_t(ids[slot]) : -1;
+  }
+};
+
+template <typename... Types> class ConfigStore {
+public:
+  using Value = Variant<Types...>;
+
+  // 类型化句柄：键的稳定编号，在重新加载后依然有效
+  template <typename T> class Handle {
+    friend class ConfigStore;
+    std::uint32_t id;
+    explicit Handle(std::uint32_t id) : id(id) {}
+  };
+
+private:
+  struct Table {
+    PerfectHashIndex index;
+    std::vector<Value> values; // 以稳定编号为下标；缺失的键为空 Variant
+  };
+
+  // 键的稳定编号和第一次加载时确定的类型（在 Types 中的下标）
+  struct KeyInfo {
+    std::uint32_t id;
+    std::uint32_t type;
+  };
+
+  std::atomic<Table const *> current{nullptr};
+
+  // 以下成员只由加载者在 mutex 保护下访问
+  std::mutex reloadMutex;
+  RetireList<Table> retired;
+  std::unordered_map<std::string, KeyInfo> keyIds;
+
+  template <typename T> static constexpr std::uint32_t typeIndex() {
+    constexpr bool same[] = {std::is_same_v<T, Types>...};
+    std::uint32_t i = 0;
+    while (!same[i]) {
+      ++i;
+    }
+    return i;
+  }
+  static std::uint32_t typeIndexOf(Value const &value) {
+    return value.visit([](auto const &alternative) {
+      return typeIndex<std::decay_t<decltype(alternative)>>();
+    });
+  }
+
+public:
+  // 读快照：存在期间当前表不会被回收，get/find 返回的引用一直有效，
+  // 但看不到之后的重新加载。快照只能在创建它的线程中使用和析构；
+  // 同一线程可以同时持有多个快照。
+  class Snapshot {
+    friend class ConfigStore;
+    EpochGuard guard;
+    Table const *table;
+
+    explicit Snapshot(ConfigStore const &store) : table(store.current.load()) {
+      if (!table) {
+        throw std::logic_error("config store not loaded");
+      }
+    }
+
+  public:
+    Snapshot(Snapshot const &) = delete;
+    Snapshot &operator=(Snapshot const &) = delete;
+
+    // 键必须在这张表中；键的类型在第一次加载时就已固定
+    template <typename T> T const &get(Handle<T> h) const {
+      return table->values[h.id].template get<T>();
+    }
+
+    template <typename T> T const *find(std::string_view key) const {
+      std::int64_t id = table->index.find(key);
+      if (id < 0 || !table->values[id].template is<T>()) {
+        return nullptr;
+      }
+      return &table->values[id].template get<T>();
+    }
+  };
+
+  ConfigStore() = default;
+  ConfigStore(ConfigStore const &) = delete;
+  ConfigStore &operator=(ConfigStore const &) = delete;
+
+  // 析构时不能有存活的快照；retired 中的旧表随之释放
+  ~ConfigStore() { delete current.load(); }
+
+  // 加载（或重新加载）全部配置，冻结为新表后原子替换。
+  // 键第一次出现时确定其类型，之后的加载（即使中间有加载缺少该键）都不能
+  // 改变它。先检查全部输入再生效：抛出异常时 store 保持不变。
+  void load(std::vector<std::pair<std::string, Value>> entries) {
+    std::lock_guard<std::mutex> lock(reloadMutex);
+
+    std::uint32_t next = std::uint32_t(keyIds.size());
+    std::unordered_map<std::string_view, KeyInfo> added;
+    std::vector<std::pair<std::string, std::uint32_t>> indexed;
+    indexed.reserve(entries.size());
+    std::vector<bool> seen(keyIds.size() + entries.size(), false);
+    for (auto const &[key, value] : entries) {
+      if (value.empty()) {
+        throw std::invalid_argument("empty config value: " + key);
+      }
+      KeyInfo info{next, typeIndexOf(value)};
+      if (auto it = keyIds.find(key); it != keyIds.end()) {
+        info = it->second;
+      } else if (auto it = added.find(key); it != added.end()) {
+        info = it->second;
+      } else {
+        added.emplace(key, info);
+        ++next;
+      }
+      if (seen[info.id]) {
+        throw std::invalid_argument("duplicate config key: " + key);
+      }
+      seen[info.id] = true;
+      if (info.type != typeIndexOf(value)) {
+        throw std::invalid_argument("config key changed type: " + key);
+      }
+      indexed.emplace_back(key, info.id);
+    }
+
+    auto fresh = std::make_unique<Table>();
+    fresh->index = PerfectHashIndex(indexed);
+    fresh->values.resize(next);
+    for (auto &value : fresh->values) {
+      value.destroy(); // 默认为空，表示该键不在本次加载中
+    }
+    for (std::size_t i = 0; i != entries.size(); ++i) {
+      fresh->values[indexed[i].second] = std::move(entries[i].second);
+    }
+    for (auto const &[key, info] : added) {
+      keyIds.emplace(std::string(key), info);
+    }
+
+    Table const *old = current.exchange(fresh.release());
+    if (old) {
+      retired.retire(old);
+    }
+  }
+
+  // 读取当前表：一次线程局部的纪元写入，不与其他读者竞争
+  Snapshot read() const { return Snapshot(*this); }
+
+  // 通过完美哈希查找键并检查类型，返回可以反复使用的句柄
+  template <typename T> Handle<T> handle(std::string_view key) const {
+    Snapshot snapshot = read();
+    std::int64_t id = snapshot.table->index.find(key);
+    if (id < 0 || !snapshot.table->values[id].template is<T>()) {
+      throw std::out_of_range("no config key of requested type: " +
+                              std::string(key));
+    }
+    return Handle<T>(std::uint32_t(id));
+  }
+};
@@ -0,0 +1,148 @@
+#include "variant_column.h"
+#include "varient.h"
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+
+struct Circle {
+  double r;
+};
+struct Rect {
+  double w, h;
+};
+struct Overlap {
+  char const *operator()(Circle const &, Circle const &) const {
+    return "circle-circle";
+  }
+  char const *operator()(Circle const &, Rect const &) const {
+    return "circle-rect";
+  }
+  char const *operator()(Rect const &, Circle const &) const {
+    return "rect-circle";
+  }
+  char const *operator()(Rect const &, Rect const &) const {
+    return "rect-rect";
+  }
+};
+
+// Layout
+struct Empty {};
+struct WithFlag {
+  double value;
+  bool flag;
+};
+// 用户声明 niche：flag 字节只会是 0 或 1
+template <> struct VariantNicheT<WithFlag> {
+  static constexpr bool exists = true;
+  static constexpr std::size_t offset = offsetof(WithFlag, flag);
+  static constexpr unsigned firstInvalid = 2;
+};
+
+// 没有 niche 时使用默认布局：缓冲区 + 1 字节 discriminator，再按对齐补齐
+static_assert(sizeof(Variant<char>) == 2);
+static_assert(sizeof(Variant<char, short>) == 4);
+static_assert(sizeof(Variant<int, float>) == 8);
+static_assert(sizeof(Variant<int, double>) == 16);
+static_assert(sizeof(Variant<char[7], short>) == 8);
+static_assert(sizeof(Variant<Empty, char>) == 2);
+static_assert(sizeof(Variant<bool, Empty>) == 2); // Empty 放不进 niche 之前
+// 声明了 niche 的类型：discriminator 编码进 flag 字节
+static_assert(sizeof(WithFlag) == 16);
+static_assert(sizeof(Variant<WithFlag>) == 16);
+static_assert(sizeof(Variant<WithFlag, int, double>) == 16);
+static_assert(sizeof(Variant<int, WithFlag, char[8]>) == 16);
+static_assert(sizeof(Variant<WithFlag, char[9]>) == 24); // char[9] 覆盖 flag
+// 内层变体的 discriminator 字节作为外层变体的 niche
+static_assert(sizeof(Variant<Variant<int, double>, int>) == 16);
+static_assert(sizeof(Variant<Variant<int, double>, double, char>) == 16);
+static_assert(sizeof(Variant<Variant<Variant<int, double>, int>, long>) == 16);
+static_assert(sizeof(Variant<Variant<WithFlag, int>, double>) == 16);
+static_assert(sizeof(Variant<Variant<char, short>, char>) == 4);
+
+// Trivially copyable
+struct Point {
+  int x, y;
+};
+static_assert(std::is_trivially_copyable_v<Variant<int, double, Point>>);
+static_assert(std::is_trivially_destructible_v<Variant<int, double, Point>>);
+static_assert(std::is_trivially_copyable_v<Variant<WithFlag, int>>);
+static_assert(!std::is_trivially_copyable_v<Variant<int, std::string>>);
+static_assert(!std::is_trivially_destructible_v<Variant<int, std::string>>);
+static_assert(std::is_copy_constructible_v<Variant<int, std::string>>);
+
+void test_layout() {
+  Variant<WithFlag, int, double> v(WithFlag{1.5, true});
+  std::cout << v.is<WithFlag>() << v.get<WithFlag>().flag;
+  v = 3;
+  std::cout << v.is<int>() << v.get<int>();
+  v = WithFlag{2.5, false};
+  std::cout << v.is<WithFlag>() << v.get<WithFlag>().flag;
+  v = 4.5;
+  std::cout << v.is<double>() << v.get<double>() << '\n';
+
+  Variant<Variant<int, double>, int> nested(Variant<int, double>(2.5));
+  std::cout << nested.is<Variant<int, double>>()
+            << nested.get<Variant<int, double>>().get<double>();
+  nested = 7;
+  std::cout << nested.is<int>() << nested.get<int>();
+  nested = Variant<int, double>(8);
+  std::cout << nested.get<Variant<int, double>>().get<int>() << '\n';
+
+  Variant<int, double, Point> p1(Point{1, 2}), p2(3.5);
+  p2 = p1;
+  Variant<int, double, Point> p3(p2);
+  std::cout << p3.is<Point>() << p3.get<Point>().y << '\n';
+}
+
+int main() {
+  Variant<int, double, std::string> field(17);
+  if (field.is<int>()) {
+    std::cout << "Field stores the integer " << field.get<int>() << std::endl;
+  }
+  field = 42;      // assign value of same type
+  field = "hello"; // assign value of different type
+  std::cout << "Field now stores the string \"" << field.get<std::string>()
+            << '\"' << std::endl;
+
+  // Visit
+  Variant<int, short, double, float> v(1.5);
+  auto result = v.visit([](auto const &value) { return value + 1; });
+  std::cout << typeid(result).name() << " " << result << '\n';
+
+  // Copy/Move with conversion
+  Variant<short, float, char const *> v1((short)123);
+  Variant<int, std::string, double> v2(v1);
+  std::cout << "v2 contains the integer " << v2.get<int>() << '\n';
+  v1 = 3.14f;
+  Variant<double, int, std::string> v3(std::move(v1));
+  std::cout << "v3 contains the double " << v3.get<double>() << '\n';
+  v1 = "hello";
+  Variant<double, int, std::string> v4(std::move(v1));
+  std::cout << "v4 contains the string " << v4.get<std::string>() << '\n';
+
+  // 类型较多时 visit 通过跳转表分派
+  Variant<char, short, int, long, float, double, std::string> many(
+      std::string("jump table"));
+  many.visit([](auto const &value) { std::cout << value << '\n'; });
+
+  // 多个 variant 同时访问（double dispatch）
+  Variant<Circle, Rect> a(Circle{1.0}), b(Rect{2.0, 3.0});
+  std::cout << a.visit(Overlap{}, b) << " " << b.visit(Overlap{}, a) << '\n';
+  auto sum = Variant<int, double>(2).visit(
+      [](auto x, auto y, auto z) { return x + y + z; }, v,
+      Variant<short, long>(10L));
+  std::cout << typeid(sum).name() << " " << sum << '\n';
+
+  test_layout();
+
+  // 按类型分桶存储，批量访问
+  VariantColumn<int, double, std::string> column(true);
+  column.pushBack(Variant<int, double, std::string>(1));
+  column.pushBack(Variant<int, double, std::string>(std::string("two")));
+  column.pushBack(Variant<int, double, std::string>(3.0));
+  column.pushBack(4);
+  column.visit([](auto const &value) { std::cout << value << ' '; });
+  std::cout << '\n';
+  column.visitInOrder([](auto const &value) { std::cout << value << ' '; });
+  std::cout << column[1].get<std::string>() << ' ' << column.size() << '\n';
+}
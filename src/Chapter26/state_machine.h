@@ -0,0 +1,96 @@
+#pragma once
+#include "varient.h"
+#include <type_traits>
+#include <utility>
+
+// 基于 Variant 的编译期状态机
+// 状态是 Variant 的备选类型，事件是普通类型，转移表是 Transition 组成的
+// Typelist。process(event) 通过 Variant::visit 的跳转表按当前状态分派，
+// 每个 (状态, 事件) 对应的处理在编译期确定：没有堆分配，也没有虚函数调用。
+
+template <typename From, typename Event, typename To> struct Transition {};
+
+// 在转移表中查找 (From, Event) 对应的目标状态，找不到时为 void
+template <typename List, typename From, typename Event,
+          bool Empty = IsEmpty<List>::value>
+struct FindTransitionT {
+  using Type = void;
+};
+template <typename List, typename From, typename Event>
+struct FindTransitionT<List, From, Event, false>
+    : FindTransitionT<PopFront<List>, From, Event> {};
+template <typename To, typename... Tail, typename From, typename Event>
+struct FindTransitionT<Typelist<Transition<From, Event, To>, Tail...>, From,
+                       Event, false> {
+  using Type = To;
+};
+
+template <typename List, typename From, typename Event>
+using FindTransition = typename FindTransitionT<List, From, Event>::Type;
+
+// 构造目标状态：优先使用 To(From const&, Event const&)，其次 To(Event const&)，
+// 否则默认构造。
+template <typename To, typename From, typename Event>
+To enterState(From const &from, Event const &event) {
+  if constexpr (std::is_constructible_v<To, From const &, Event const &>) {
+    return To(from, event);
+  } else if constexpr (std::is_constructible_v<To, Event const &>) {
+    return To(event);
+  } else {
+    return To{};
+  }
+}
+
+template <typename StateList, typename TransitionList> class StateMachine;
+
+template <typename... States, typename... Transitions>
+class StateMachine<Typelist<States...>, Typelist<Transitions...>> {
+  using TransitionTable = Typelist<Transitions...>;
+
+  template <typename T> static constexpr bool isState() {
+    return (std::is_same_v<T, States> || ...);
+  }
+  template <typename From, typename Event, typename To>
+  static constexpr bool isValid(Transition<From, Event, To>) {
+    return isState<From>() && isState<To>();
+  }
+  static_assert((isValid(Transitions{}) && ...),
+                "transition refers to an unknown state");
+
+  Variant<States...> current; // 初始状态为第一个状态
+
+public:
+  StateMachine() = default;
+  template <typename State>
+    requires(isState<std::decay_t<State>>())
+  explicit StateMachine(State &&initial)
+      : current(std::forward<State>(initial)) {}
+
+  // 处理一个事件；当前状态没有对应的转移时返回 false，状态不变
+  template <typename Event> bool process(Event const &event) {
+    return current.template visit<bool>([&](auto &state) {
+      using From = std::decay_t<decltype(state)>;
+      using To = FindTransition<TransitionTable, From, Event>;
+      if constexpr (std::is_void_v<To>) {
+        return false;
+      } else {
+        // 先用旧状态构造新状态，再替换（旧状态在赋值时析构）
+        To next = enterState<To>(state, event);
+        current = std::move(next);
+        return true;
+      }
+    });
+  }
+
+  template <typename State> bool is() const {
+    return current.template is<State>();
+  }
+  template <typename State> State const &get() const {
+    return current.template get<State>();
+  }
+  Variant<States...> const &state() const { return current; }
+
+  template <typename Visitor> decltype(auto) visit(Visitor &&vis) const {
+    return current.visit(std::forward<Visitor>(vis));
+  }
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include "varient.h"
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// VariantColumn：接收 Variant<Types...>，但按活动类型分桶存储，每种类型一个
+// 连续的 vector。批量访问时对每个桶运行一个类型已知的紧凑循环，访问者可以
+// 被内联，循环内没有按元素的类型分派。
+// 需要保留插入顺序时，额外记录每个元素所在的桶和桶内下标。
+template <typename... Types> class VariantColumn {
+  static_assert(sizeof...(Types) <= 255, "too many alternatives");
+
+  struct Slot {
+    std::uint8_t type; // 类型在 Types 中的下标
+    std::uint32_t index;
+  };
+
+  std::tuple<std::vector<Types>...> columns;
+  std::vector<Slot> order;
+  bool trackOrder;
+
+  template <typename T>
+  static constexpr std::uint8_t TypeIndex =
+      FindIndexOfT<Typelist<Types...>, T>::value;
+
+  template <typename T> void record() {
+    if (trackOrder) {
+      order.push_back(Slot{TypeIndex<T>,
+                           static_cast<std::uint32_t>(column<T>().size() - 1)});
+    }
+  }
+
+  // 按插入顺序访问时仍需按元素分派：用 Slot::type 索引一张跳转表
+  template <typename Self, typename Visitor>
+  static void visitSlot(Self &self, Slot const &slot, Visitor &vis) {
+    using Thunk = void (*)(Self &, Visitor &, std::uint32_t);
+    static constexpr Thunk table[] = {
+        [](Self &owner, Visitor &vis, std::uint32_t index) {
+          vis(owner.template column<Types>()[index]);
+        }...};
+    table[slot.type](self, vis, slot.index);
+  }
+
+public:
+  explicit VariantColumn(bool trackOrder = false) : trackOrder(trackOrder) {}
+
+  template <typename T> std::vector<T> &column() {
+    return std::get<std::vector<T>>(columns);
+  }
+  template <typename T> std::vector<T> const &column() const {
+    return std::get<std::vector<T>>(columns);
+  }
+
+  std::size_t size() const { return (column<Types>().size() + ...); }
+  bool empty() const { return size() == 0; }
+  bool tracksOrder() const { return trackOrder; }
+
+  // 直接追加某个类型的值，不经过 Variant
+  template <typename T>
+    requires(!std::is_same_v<std::decay_t<T>, Variant<Types...>>)
+  void pushBack(T &&value) {
+    using U = std::decay_t<T>;
+    column<U>().push_back(std::forward<T>(value));
+    record<U>();
+  }
+
+  void pushBack(Variant<Types...> const &value) {
+    value.visit([this](auto const &elem) { pushBack(elem); });
+  }
+  void pushBack(Variant<Types...> &&value) {
+    std::move(value).visit(
+        [this](auto &&elem) { pushBack(std::move(elem)); });
+  }
+
+  void reserve(std::size_t n) {
+    (column<Types>().reserve(n), ...);
+    if (trackOrder) {
+      order.reserve(n);
+    }
+  }
+
+  void clear() {
+    (column<Types>().clear(), ...);
+    order.clear();
+  }
+
+  // 批量访问：逐个桶执行 vis，桶内顺序与插入顺序一致，桶之间按 Types 的顺序
+  template <typename Visitor> void visit(Visitor &&vis) {
+    (
+        [&vis](std::vector<Types> &elems) {
+          for (Types &elem : elems) {
+            vis(elem);
+          }
+        }(column<Types>()),
+        ...);
+  }
+  template <typename Visitor> void visit(Visitor &&vis) const {
+    (
+        [&vis](std::vector<Types> const &elems) {
+          for (Types const &elem : elems) {
+            vis(elem);
+          }
+        }(column<Types>()),
+        ...);
+  }
+
+  // 按原始插入顺序访问（需要 trackOrder）
+  template <typename Visitor> void visitInOrder(Visitor &&vis) {
+    assert(trackOrder);
+    for (Slot const &slot : order) {
+      visitSlot(*this, slot, vis);
+    }
+  }
+  template <typename Visitor> void visitInOrder(Visitor &&vis) const {
+    assert(trackOrder);
+    for (Slot const &slot : order) {
+      visitSlot(*this, slot, vis);
+    }
+  }
+
+  // 按原始位置取出元素（需要 trackOrder）
+  Variant<Types...> operator[](std::size_t i) const {
+    assert(trackOrder);
+    Variant<Types...> result;
+    auto assign = [&result](auto const &elem) { result = elem; };
+    visitSlot(*this, order[i], assign);
+    return result;
+  }
+};
@@ -0,0 +1,35 @@
+// Variant 的编译期开销：生成 SIZE 个不同类型组成的 Variant，
+// 用 VISIT（visit 一次）或 ACCESS（对每个类型调用 is/get）选择要测的操作。
+// 只需要编译（-fsyntax-only），见 CMakeLists.txt 中的 compile-bench。
+// 运行时的 visit 开销见 visit_bench.cc。
+#include "varient.h"
+#include <cstddef>
+#include <utility>
+
+#ifndef SIZE
+#define SIZE 16
+#endif
+
+template <std::size_t I> struct Alternative {
+  int value;
+};
+
+template <std::size_t... Is>
+Variant<Alternative<Is>...> makeVariant(std::index_sequence<Is...>);
+
+using V = decltype(makeVariant(std::make_index_sequence<SIZE>()));
+
+template <std::size_t... Is>
+int accessAll(V const &v, std::index_sequence<Is...>) {
+  return ((v.is<Alternative<Is>>() ? v.get<Alternative<Is>>().value : 0) +
+          ...);
+}
+
+int main() {
+  V v(Alternative<SIZE / 2>{1});
+#if defined(VISIT)
+  return v.visit([](auto const &alternative) { return alternative.value; });
+#elif defined(ACCESS)
+  return accessAll(v, std::make_index_sequence<SIZE>());
+#endif
+}
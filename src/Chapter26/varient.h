@@ -1,15 +1,74 @@
+#pragma once
 #include "../Chapter24/type_list.h"
+#include <cassert>
 #include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <new> // for std::launder()
 #include <type_traits>
+#include <utility>
 
-template <typename... Types> class VariantStorage {
+class EmptyVariant : public std::exception {};
+
+// FindIndexof
+template <typename List, typename T, unsigned N = 0,
+          bool Empty = IsEmpty<List>::value>
+struct FindIndexOfT;
+template <typename List, typename T, unsigned N>
+struct FindIndexOfT<List, T, N, false>
+    : public std::conditional_t<std::is_same_v<Front<List>, T>,
+                                std::integral_constant<unsigned, N>,
+                                FindIndexOfT<PopFront<List>, T, N + 1>> {};
+
+template <typename List, typename T, unsigned N>
+struct FindIndexOfT<List, T, N, true> {};
+
+// Storage layout
+// Niche：某个类型的对象表示中，偏移 offset 处的字节永远不会取
+// [firstInvalid, 255] 中的值。变体可以把 discriminator 编码进这些值里，
+// 从而不需要单独的 discriminator 字节。默认没有 niche，用户可以特化。
+template <typename T> struct VariantNicheT {
+  static constexpr bool exists = false;
+};
+
+template <> struct VariantNicheT<bool> {
+  static constexpr bool exists = true;
+  static constexpr std::size_t offset = 0;
+  static constexpr unsigned firstInvalid = 2;
+};
+
+// T 可以作为 niche 的持有者：剩余的值足够编码空状态和其他每个类型，
+// 并且其他类型都放得进 niche 字节之前的空间。
+template <typename T, typename... Types> constexpr bool canHoldNiche() {
+  if constexpr (VariantNicheT<T>::exists) {
+    return 256 - VariantNicheT<T>::firstInvalid > sizeof...(Types) &&
+           ((std::is_same_v<T, Types> ||
+             sizeof(Types) <= VariantNicheT<T>::offset) &&
+            ...);
+  } else {
+    return false;
+  }
+}
+
+template <typename List, typename... Types> struct NicheHolderT {
+  using Type = void;
+};
+template <typename Head, typename... Tail, typename... Types>
+struct NicheHolderT<Typelist<Head, Tail...>, Types...>
+    : std::conditional_t<canHoldNiche<Head, Types...>(), IdentityT<Head>,
+                         NicheHolderT<Typelist<Tail...>, Types...>> {};
+
+// 默认布局：足够大的缓冲区后面跟一个 discriminator 字节
+template <typename... Types> class TaggedVariantStorage {
   using LargestT = LargestType<Typelist<Types...>>;
   alignas(Types...) unsigned char buffer[sizeof(LargestT)];
   unsigned char discriminator = 0;
 
 public:
+  // discriminator 字节中未使用的值也可以作为外层变体的 niche
+  static constexpr std::size_t NicheOffset = sizeof(LargestT);
+  static constexpr unsigned FirstUnusedValue = sizeof...(Types) + 1;
+
   unsigned char getDiscriminator() const { return discriminator; }
   void setDiscriminator(unsigned char d) { discriminator = d; }
   void *getRawBuffer() { return buffer; }
@@ -22,18 +81,69 @@ public:
   }
 };
 
-// FindIndexof
-template <typename List, typename T, unsigned N = 0,
-          bool Empty = IsEmpty<List>::value>
-struct FindIndexOfT;
-template <typename List, typename T, unsigned N>
-struct FindIndexOfT<List, T, N, false>
-    : public std::conditional_t<std::is_same_v<Front<List>, T>,
-                                std::integral_constant<unsigned, N>,
-                                FindIndexOfT<PopFront<List>, T, N + 1>> {};
+// Niche 布局：Holder 活动时 niche 字节是它自己的合法值；
+// 否则 niche 字节存放 firstInvalid + discriminator。
+template <typename Holder, typename... Types> class NicheVariantStorage {
+  using Niche = VariantNicheT<Holder>;
+  static constexpr unsigned HolderDiscriminator =
+      FindIndexOfT<Typelist<Types...>, Holder>::value + 1;
 
-template <typename List, typename T, unsigned N>
-struct FindIndexOfT<List, T, N, true> {};
+  alignas(Types...) unsigned char buffer[sizeof(Holder)];
+
+  unsigned char nicheByte() const {
+    return std::launder(reinterpret_cast<unsigned char const *>(buffer))
+        [Niche::offset];
+  }
+
+public:
+  static constexpr std::size_t NicheOffset = Niche::offset;
+  static constexpr unsigned FirstUnusedValue =
+      Niche::firstInvalid + sizeof...(Types) + 1;
+
+  NicheVariantStorage() { setDiscriminator(0); }
+
+  unsigned char getDiscriminator() const {
+    unsigned char b = nicheByte();
+    return b < Niche::firstInvalid ? HolderDiscriminator
+                                   : b - Niche::firstInvalid;
+  }
+  void setDiscriminator(unsigned char d) {
+    // Holder 的值刚刚构造在缓冲区中，niche 字节已经是合法值
+    if (d != HolderDiscriminator) {
+      std::launder(reinterpret_cast<unsigned char *>(buffer))[Niche::offset] =
+          Niche::firstInvalid + d;
+    }
+  }
+  void *getRawBuffer() { return buffer; }
+  const void *getRawBuffer() const { return buffer; }
+  template <typename T> T *getBufferAs() {
+    return std::launder(reinterpret_cast<T *>(buffer));
+  }
+  template <typename T> T const *getBufferAs() const {
+    return std::launder(reinterpret_cast<T const *>(buffer));
+  }
+};
+
+// 布局策略：能找到 niche 就把 discriminator 编码进去，否则使用默认布局
+template <typename... Types> struct VariantLayoutT {
+  using Holder = typename NicheHolderT<Typelist<Types...>, Types...>::Type;
+  using Type = std::conditional_t<std::is_void_v<Holder>,
+                                  TaggedVariantStorage<Types...>,
+                                  NicheVariantStorage<Holder, Types...>>;
+};
+
+template <typename... Types>
+using VariantStorage = typename VariantLayoutT<Types...>::Type;
+
+// 一个变体的 discriminator 字节中未使用的值可以作为外层变体的 niche
+template <typename... Types> class Variant;
+template <typename... Types> struct VariantNicheT<Variant<Types...>> {
+  static constexpr bool exists =
+      VariantStorage<Types...>::FirstUnusedValue < 256;
+  static constexpr std::size_t offset = VariantStorage<Types...>::NicheOffset;
+  static constexpr unsigned firstInvalid =
+      VariantStorage<Types...>::FirstUnusedValue;
+};
 
 // Variant Choice
 template <typename... Types> class Variant;
@@ -55,8 +165,12 @@ public:
   VariantChoice(T &&value);      // see variantchoiceinit.hpp
   bool destroy() {
     if (getDerived().getDiscriminator() == Discriminator) {
-      getDerived().template getBufferAs<T>()->~T();
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        getDerived().template getBufferAs<T>()->~T();
+      }
+      return true;
     }
+    return false;
   }
   Derived &operator=(T const &value); // see variantchoiceassign.hpp
   Derived &operator=(T &&value);      // see variantchoiceassign.hpp
@@ -83,8 +197,14 @@ auto VariantChoice<T, Types...>::operator=(T const &value) -> Derived & {
     *getDerived().template getBufferAs<T>() = value;
   } else {
     // assign new value of different type:
-    getDerived().destroy();                     // try destroy() for all types
-    new (getDerived().getRawBuffer()) T(value); // place new value
+    getDerived().destroy(); // try destroy() for all types
+    try {
+      new (getDerived().getRawBuffer()) T(value); // place new value
+    } catch (...) {
+      // 构造了一半的值可能已经改写了 niche 字节
+      getDerived().setDiscriminator(0);
+      throw;
+    }
     getDerived().setDiscriminator(Discriminator);
   }
   return getDerived();
@@ -98,17 +218,166 @@ auto VariantChoice<T, Types...>::operator=(T &&value) -> Derived & {
   } else {
     // assign new value of different type:
     getDerived().destroy(); // try destroy() for all types
-    new (getDerived().getRawBuffer()) T(std::move(value)); // place new value
+    try {
+      new (getDerived().getRawBuffer()) T(std::move(value)); // place new value
+    } catch (...) {
+      getDerived().setDiscriminator(0);
+      throw;
+    }
     getDerived().setDiscriminator(Discriminator);
   }
   return getDerived();
 }
 
+// Visit result type
+class ComputedResultType;
+
+// an explicitly-provided visitor result type:
+template <typename R, typename Visitor, typename... ElementTypes>
+class VisitResultT {
+public:
+  using Type = R;
+};
+
+// the result type produced when calling a visitor with a value of type T:
+template <typename Visitor, typename T>
+using VisitElementResult =
+    decltype(std::declval<Visitor>()(std::declval<T>()));
+
+// the common result type for a visitor called with each of the given element
+// types:
+template <typename Visitor, typename... ElementTypes>
+class VisitResultT<ComputedResultType, Visitor, ElementTypes...> {
+public:
+  using Type = std::common_type_t<VisitElementResult<Visitor, ElementTypes>...>;
+};
+
+template <typename R, typename Visitor, typename... ElementTypes>
+using VisitResult = typename VisitResultT<R, Visitor, ElementTypes...>::Type;
+
+// 按 Variant 的值类别（&、const&、&&）转发其中存储的 T
+template <typename V, typename T>
+using ForwardLike = std::conditional_t<
+    std::is_lvalue_reference_v<V>,
+    std::conditional_t<std::is_const_v<std::remove_reference_t<V>>, T const &,
+                       T &>,
+    T &&>;
+
+// Multi-variant visit
+template <typename V> struct VariantTypesT;
+template <typename... Types> struct VariantTypesT<Variant<Types...>> {
+  using Type = Typelist<Types...>;
+  static constexpr std::size_t size = sizeof...(Types);
+};
+
+// 把 N 维下标压平成一维，最后一维变化最快
+template <std::size_t... Sizes> struct FlatIndexT {
+  static constexpr std::size_t sizes[] = {Sizes...};
+  static constexpr std::size_t count = (std::size_t(1) * ... * Sizes);
+  static constexpr std::size_t stride(std::size_t dim) {
+    std::size_t result = 1;
+    for (std::size_t d = dim + 1; d != sizeof...(Sizes); ++d) {
+      result *= sizes[d];
+    }
+    return result;
+  }
+  static constexpr std::size_t indexOf(std::size_t flat, std::size_t dim) {
+    return flat / stride(dim) % sizes[dim];
+  }
+};
+
+// 同时访问多个 variant：所有类型组合在编译期展开为一张一维跳转表，
+// 由各 variant 的 discriminator 计算出下标后只需一次间接调用。
+// Vs 是各 variant 被转发时的类型（Variant&、Variant const& 或 Variant）。
+template <typename Visitor, typename VList, typename Dims> class MultiVisitT;
+template <typename Visitor, typename... Vs, std::size_t... Dims>
+class MultiVisitT<Visitor, Typelist<Vs...>, std::index_sequence<Dims...>> {
+  using Index = FlatIndexT<VariantTypesT<std::remove_cvref_t<Vs>>::size...>;
+
+  template <std::size_t Dim>
+  using VariantAt = NthElement<Typelist<Vs...>, Dim>;
+  template <std::size_t Flat, std::size_t Dim>
+  using Alternative = NthElement<
+      typename VariantTypesT<std::remove_cvref_t<VariantAt<Dim>>>::Type,
+      Index::indexOf(Flat, Dim)>;
+  template <std::size_t Flat, std::size_t Dim>
+  using ElementRef = ForwardLike<VariantAt<Dim>, Alternative<Flat, Dim>>;
+  template <std::size_t Flat>
+  using ElementResult = decltype(std::declval<Visitor>()(
+      std::declval<ElementRef<Flat, Dims>>()...));
+
+  template <typename Flats> struct CommonResultT;
+  template <std::size_t... Flats>
+  struct CommonResultT<std::index_sequence<Flats...>> {
+    using Type = std::common_type_t<ElementResult<Flats>...>;
+  };
+
+  template <typename R, std::size_t Flat>
+  static R visitAlternatives(Visitor &&vis, Vs &&...vs) {
+    return static_cast<R>(std::forward<Visitor>(vis)(
+        static_cast<ElementRef<Flat, Dims>>(
+            *vs.template getBufferAs<Alternative<Flat, Dims>>())...));
+  }
+
+  template <typename R, std::size_t... Flats>
+  static R dispatch(std::size_t flat, std::index_sequence<Flats...>,
+                    Visitor &&vis, Vs &&...vs) {
+    using Thunk = R (*)(Visitor &&, Vs &&...);
+    static constexpr Thunk table[] = {&visitAlternatives<R, Flats>...};
+    return table[flat](std::forward<Visitor>(vis), std::forward<Vs>(vs)...);
+  }
+
+public:
+  using CommonResult =
+      typename CommonResultT<std::make_index_sequence<Index::count>>::Type;
+
+  template <typename R> static R visit(Visitor &&vis, Vs &&...vs) {
+    if (((vs.getDiscriminator() == 0) || ...)) {
+      throw EmptyVariant();
+    }
+    std::size_t flat =
+        ((std::size_t(vs.getDiscriminator() - 1) * Index::stride(Dims)) + ...);
+    return dispatch<R>(flat, std::make_index_sequence<Index::count>(),
+                       std::forward<Visitor>(vis), std::forward<Vs>(vs)...);
+  }
+};
+
+template <typename Visitor, typename... Vs>
+using MultiVisit =
+    MultiVisitT<Visitor, Typelist<Vs...>, std::index_sequence_for<Vs...>>;
+
+template <typename R, typename Visitor, typename... Vs>
+class MultiVisitResultT {
+public:
+  using Type = R;
+};
+template <typename Visitor, typename... Vs>
+class MultiVisitResultT<ComputedResultType, Visitor, Vs...> {
+public:
+  using Type = typename MultiVisit<Visitor, Vs...>::CommonResult;
+};
+
+template <typename R, typename Visitor, typename... Vs>
+using MultiVisitResult = typename MultiVisitResultT<R, Visitor, Vs...>::Type;
+
 // Variant
 template <typename... Types>
 class Variant : private VariantStorage<Types...>,
                 private VariantChoice<Types, Types...>... {
   template <typename T, typename... OtherTypes> friend class VariantChoice;
+  template <typename Visitor, typename VList, typename Dims>
+  friend class MultiVisitT;
+
+  static constexpr bool TriviallyCopyConstructible =
+      (std::is_trivially_copy_constructible_v<Types> && ...);
+  static constexpr bool TriviallyMoveConstructible =
+      (std::is_trivially_move_constructible_v<Types> && ...);
+  static constexpr bool TriviallyCopyAssignable =
+      (std::is_trivially_copy_assignable_v<Types> && ...);
+  static constexpr bool TriviallyMoveAssignable =
+      (std::is_trivially_move_assignable_v<Types> && ...);
+  static constexpr bool TriviallyDestructible =
+      (std::is_trivially_destructible_v<Types> && ...);
 
 public:
   template <typename T> bool is() const {
@@ -117,23 +386,23 @@ public:
   }
   template <typename T> T &get() & {
     if (empty()) {
-      // ... throw exception
+      throw EmptyVariant();
     }
-    static_assert(is<T>());
+    assert(is<T>());
     return *this->template getBufferAs<T>();
   }
   template <typename T> T const &get() const & {
     if (empty()) {
-      // ... throw exception
+      throw EmptyVariant();
     }
-    static_assert(is<T>());
+    assert(is<T>());
     return *this->template getBufferAs<T>();
   }
   template <typename T> T &&get() && {
     if (empty()) {
-      // ... throw exception
+      throw EmptyVariant();
     }
-    static_assert(is<T>());
+    assert(is<T>());
     return std::move(*this->template getBufferAs<T>());
   }
 
@@ -144,27 +413,266 @@ public:
   VisitResult<R, Visitor, Types const &...> visit(Visitor &&vis) const &;
   template <typename R = ComputedResultType, typename Visitor>
   VisitResult<R, Visitor, Types &&...> visit(Visitor &&vis) &&;
+  // 多个 variant 同时访问：vis(a, b, ...) 按各自的活动值调用
+  template <typename R = ComputedResultType, typename Visitor, typename Other,
+            typename... Others>
+  MultiVisitResult<R, Visitor, Variant &, Other, Others...>
+  visit(Visitor &&vis, Other &&other, Others &&...others) &;
+  template <typename R = ComputedResultType, typename Visitor, typename Other,
+            typename... Others>
+  MultiVisitResult<R, Visitor, Variant const &, Other, Others...>
+  visit(Visitor &&vis, Other &&other, Others &&...others) const &;
+  template <typename R = ComputedResultType, typename Visitor, typename Other,
+            typename... Others>
+  MultiVisitResult<R, Visitor, Variant, Other, Others...>
+  visit(Visitor &&vis, Other &&other, Others &&...others) &&;
   using VariantChoice<Types, Types...>::VariantChoice...;
-  Variant();                      // see variantdefaultctor.hpp
+  Variant(); // see variantdefaultctor.hpp
+  // 所有类型都可平凡复制/移动/析构时，对应的特殊成员也是平凡的：
+  // 直接按字节复制缓冲区和 discriminator，Variant 本身也就是 trivially
+  // copyable 的，容器可以用 memcpy 搬移它。
+  Variant(Variant const &source)
+    requires TriviallyCopyConstructible
+  = default;
   Variant(Variant const &source); // see variantcopyctor.hpp
-  Variant(Variant &&source);      // see variantmovector.hpp
+  Variant(Variant &&source)
+    requires TriviallyMoveConstructible
+  = default;
+  Variant(Variant &&source); // see variantmovector.hpp
   template <typename... SourceTypes>
   Variant(Variant<SourceTypes...> const &source); // variantcopyctortmpl.hpp
   template <typename... SourceTypes> Variant(Variant<SourceTypes...> &&source);
   using VariantChoice<Types, Types...>::operator=...;
+  // 赋值可能切换活动类型（析构旧值再构造新值），因此还要求平凡的构造和析构
+  Variant &operator=(Variant const &source)
+    requires(TriviallyCopyConstructible && TriviallyCopyAssignable &&
+             TriviallyDestructible)
+  = default;
   Variant &operator=(Variant const &source); // see variantcopyassign.hpp
+  Variant &operator=(Variant &&source)
+    requires(TriviallyMoveConstructible && TriviallyMoveAssignable &&
+             TriviallyDestructible)
+  = default;
   Variant &operator=(Variant &&source);
   template <typename... SourceTypes>
   Variant &operator=(Variant<SourceTypes...> const &source);
   template <typename... SourceTypes>
   Variant &operator=(Variant<SourceTypes...> &&source);
   bool empty() const;
+  ~Variant()
+    requires TriviallyDestructible
+  = default;
   ~Variant() { destroy(); }
 
   void destroy();
+
+private:
+  // 访问类型为 T 的活动值；discriminator 已经由调用者检查过
+  template <typename R, typename T, typename Self, typename Visitor>
+  static R visitAlternative(Self &&self, Visitor &&vis) {
+    return static_cast<R>(std::forward<Visitor>(vis)(
+        static_cast<ForwardLike<Self, T>>(*self.template getBufferAs<T>())));
+  }
+
+  // 类型较少时逐个比较 discriminator，分支可以被内联并展开；
+  // 最后一个类型无需比较。
+  template <typename R, unsigned I, typename Self, typename Visitor>
+  static R visitBranch(Self &&self, Visitor &&vis, unsigned char d) {
+    using T = NthElement<Typelist<Types...>, I>;
+    if constexpr (I + 1 == sizeof...(Types)) {
+      return visitAlternative<R, T>(std::forward<Self>(self),
+                                    std::forward<Visitor>(vis));
+    } else {
+      if (d == I + 1) {
+        return visitAlternative<R, T>(std::forward<Self>(self),
+                                      std::forward<Visitor>(vis));
+      }
+      return visitBranch<R, I + 1>(std::forward<Self>(self),
+                                   std::forward<Visitor>(vis), d);
+    }
+  }
+
+  // 类型较多时使用编译期生成的跳转表，以 discriminator 为下标 O(1) 分派
+  template <typename R, typename Self, typename Visitor>
+  static R visitImpl(Self &&self, Visitor &&vis) {
+    unsigned char d = self.getDiscriminator();
+    if (d == 0) {
+      throw EmptyVariant();
+    }
+    if constexpr (sizeof...(Types) <= MaxBranchVisit) {
+      return visitBranch<R, 0>(std::forward<Self>(self),
+                               std::forward<Visitor>(vis), d);
+    } else {
+      using Thunk = R (*)(Self &&, Visitor &&);
+      static constexpr Thunk table[] = {
+          &visitAlternative<R, Types, Self, Visitor>...};
+      return table[d - 1](std::forward<Self>(self),
+                          std::forward<Visitor>(vis));
+    }
+  }
+
+  static constexpr std::size_t MaxBranchVisit = 4;
 };
 
 template <typename... Types> void Variant<Types...>::destroy() {
-  bool results = {VariantChoice<Types, Types...>::destroy()...};
+  if constexpr (!TriviallyDestructible) {
+    // call destroy() on each VariantChoice base class; at most one will
+    // succeed:
+    (VariantChoice<Types, Types...>::destroy(), ...);
+  }
+  // indicate that the variant does not store a value
   this->setDiscriminator(0);
 }
+
+template <typename... Types> bool Variant<Types...>::empty() const {
+  return this->getDiscriminator() == 0;
+}
+
+// Visit
+// 书中的实现：沿类型列表逐个 is<Head>() 判断，访问开销随类型个数线性增长。
+// visit() 已改用 visitImpl() 的跳转表，这里保留用于对比。
+template <typename R, typename V, typename Visitor, typename Head,
+          typename... Tail>
+R variantVisitImpl(V &&variant, Visitor &&vis, Typelist<Head, Tail...>) {
+  if (variant.template is<Head>()) {
+    return static_cast<R>(std::forward<Visitor>(vis)(
+        std::forward<V>(variant).template get<Head>()));
+  } else if constexpr (sizeof...(Tail) > 0) {
+    return variantVisitImpl<R>(std::forward<V>(variant),
+                               std::forward<Visitor>(vis), Typelist<Tail...>());
+  } else {
+    throw EmptyVariant();
+  }
+}
+
+template <typename... Types>
+template <typename R, typename Visitor>
+VisitResult<R, Visitor, Types &...> Variant<Types...>::visit(Visitor &&vis) & {
+  using Result = VisitResult<R, Visitor, Types &...>;
+  return visitImpl<Result>(*this, std::forward<Visitor>(vis));
+}
+
+template <typename... Types>
+template <typename R, typename Visitor>
+VisitResult<R, Visitor, Types const &...>
+Variant<Types...>::visit(Visitor &&vis) const & {
+  using Result = VisitResult<R, Visitor, Types const &...>;
+  return visitImpl<Result>(*this, std::forward<Visitor>(vis));
+}
+
+template <typename... Types>
+template <typename R, typename Visitor>
+VisitResult<R, Visitor, Types &&...>
+Variant<Types...>::visit(Visitor &&vis) && {
+  using Result = VisitResult<R, Visitor, Types &&...>;
+  return visitImpl<Result>(std::move(*this), std::forward<Visitor>(vis));
+}
+
+template <typename... Types>
+template <typename R, typename Visitor, typename Other, typename... Others>
+MultiVisitResult<R, Visitor, Variant<Types...> &, Other, Others...>
+Variant<Types...>::visit(Visitor &&vis, Other &&other, Others &&...others) & {
+  using Result = MultiVisitResult<R, Visitor, Variant &, Other, Others...>;
+  return MultiVisit<Visitor, Variant &, Other, Others...>::template visit<
+      Result>(std::forward<Visitor>(vis), *this, std::forward<Other>(other),
+              std::forward<Others>(others)...);
+}
+
+template <typename... Types>
+template <typename R, typename Visitor, typename Other, typename... Others>
+MultiVisitResult<R, Visitor, Variant<Types...> const &, Other, Others...>
+Variant<Types...>::visit(Visitor &&vis, Other &&other,
+                         Others &&...others) const & {
+  using Result =
+      MultiVisitResult<R, Visitor, Variant const &, Other, Others...>;
+  return MultiVisit<Visitor, Variant const &, Other, Others...>::template visit<
+      Result>(std::forward<Visitor>(vis), *this, std::forward<Other>(other),
+              std::forward<Others>(others)...);
+}
+
+template <typename... Types>
+template <typename R, typename Visitor, typename Other, typename... Others>
+MultiVisitResult<R, Visitor, Variant<Types...>, Other, Others...>
+Variant<Types...>::visit(Visitor &&vis, Other &&other, Others &&...others) && {
+  using Result = MultiVisitResult<R, Visitor, Variant, Other, Others...>;
+  return MultiVisit<Visitor, Variant, Other, Others...>::template visit<Result>(
+      std::forward<Visitor>(vis), std::move(*this), std::forward<Other>(other),
+      std::forward<Others>(others)...);
+}
+
+// Initialization and assignment
+template <typename... Types> Variant<Types...>::Variant() {
+  *this = Front<Typelist<Types...>>();
+}
+
+template <typename... Types> Variant<Types...>::Variant(Variant const &source) {
+  if (!source.empty()) {
+    source.visit([&](auto const &value) { *this = value; });
+  }
+}
+
+template <typename... Types> Variant<Types...>::Variant(Variant &&source) {
+  if (!source.empty()) {
+    std::move(source).visit([&](auto &&value) { *this = std::move(value); });
+  }
+}
+
+template <typename... Types>
+template <typename... SourceTypes>
+Variant<Types...>::Variant(Variant<SourceTypes...> const &source) {
+  if (!source.empty()) {
+    source.visit([&](auto const &value) { *this = value; });
+  }
+}
+
+template <typename... Types>
+template <typename... SourceTypes>
+Variant<Types...>::Variant(Variant<SourceTypes...> &&source) {
+  if (!source.empty()) {
+    std::move(source).visit([&](auto &&value) { *this = std::move(value); });
+  }
+}
+
+template <typename... Types>
+Variant<Types...> &Variant<Types...>::operator=(Variant const &source) {
+  if (!source.empty()) {
+    source.visit([&](auto const &value) { *this = value; });
+  } else {
+    destroy();
+  }
+  return *this;
+}
+
+template <typename... Types>
+Variant<Types...> &Variant<Types...>::operator=(Variant &&source) {
+  if (!source.empty()) {
+    std::move(source).visit([&](auto &&value) { *this = std::move(value); });
+  } else {
+    destroy();
+  }
+  return *this;
+}
+
+template <typename... Types>
+template <typename... SourceTypes>
+Variant<Types...> &
+Variant<Types...>::operator=(Variant<SourceTypes...> const &source) {
+  if (!source.empty()) {
+    source.visit([&](auto const &value) { *this = value; });
+  } else {
+    destroy();
+  }
+  return *this;
+}
+
+template <typename... Types>
+template <typename... SourceTypes>
+Variant<Types...> &
+Variant<Types...>::operator=(Variant<SourceTypes...> &&source) {
+  if (!source.empty()) {
+    std::move(source).visit([&](auto &&value) { *this = std::move(value); });
+  } else {
+    destroy();
+  }
+  return *this;
+}
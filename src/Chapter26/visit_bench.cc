@@ -0,0 +1,92 @@
+// visit() 分派开销对比：
+//   chain - 书中的 variantVisitImpl，逐个 is<Head>() 判断
+//   table - Variant::visit，小类型数时分支展开，否则使用跳转表
+//   std   - std::visit
+//   column - VariantColumn 按类型分桶后的批量访问
+#include "variant_column.h"
+#include "varient.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template <unsigned I> struct Alt {
+  static constexpr unsigned index = I;
+  int value;
+};
+
+constexpr std::size_t Count = 1 << 20;
+constexpr int Rounds = 20;
+
+template <typename F> double measure(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         (double(Count) * Rounds);
+}
+
+template <std::size_t... Is> void bench(std::index_sequence<Is...>) {
+  using Ours = Variant<Alt<Is>...>;
+  using Std = std::variant<Alt<Is>...>;
+  constexpr std::size_t N = sizeof...(Is);
+
+  using MakeOurs = Ours (*)(int);
+  using MakeStd = Std (*)(int);
+  MakeOurs makeOurs[] = {[](int x) { return Ours(Alt<Is>{x}); }...};
+  MakeStd makeStd[] = {[](int x) { return Std(Alt<Is>{x}); }...};
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<std::size_t> dist(0, N - 1);
+  std::vector<Ours> ours;
+  std::vector<Std> stds;
+  VariantColumn<Alt<Is>...> columns;
+  ours.reserve(Count);
+  stds.reserve(Count);
+  for (std::size_t i = 0; i != Count; ++i) {
+    std::size_t which = dist(gen);
+    ours.push_back(makeOurs[which](int(i)));
+    stds.push_back(makeStd[which](int(i)));
+    columns.pushBack(ours.back());
+  }
+
+  auto visitor = [](auto const &alt) {
+    return alt.value ^ int(std::decay_t<decltype(alt)>::index);
+  };
+
+  long sumChain = 0, sumTable = 0, sumStd = 0, sumColumn = 0;
+  double chain = measure([&] {
+    for (int r = 0; r != Rounds; ++r)
+      for (auto const &v : ours)
+        sumChain += variantVisitImpl<int>(v, visitor, Typelist<Alt<Is>...>());
+  });
+  double table = measure([&] {
+    for (int r = 0; r != Rounds; ++r)
+      for (auto const &v : ours)
+        sumTable += v.visit(visitor);
+  });
+  double stdv = measure([&] {
+    for (int r = 0; r != Rounds; ++r)
+      for (auto const &v : stds)
+        sumStd += std::visit(visitor, v);
+  });
+  double column = measure([&] {
+    for (int r = 0; r != Rounds; ++r)
+      columns.visit([&](auto const &alt) { sumColumn += visitor(alt); });
+  });
+
+  std::printf("%2zu alternatives: chain %6.2f ns  table %6.2f ns  "
+              "std::visit %6.2f ns  column %6.2f ns  (%s)\n",
+              N, chain, table, stdv, column,
+              sumChain == sumTable && sumTable == sumStd && sumStd == sumColumn
+                  ? "ok"
+                  : "MISMATCH");
+}
+
+int main() {
+  bench(std::make_index_sequence<2>());
+  bench(std::make_index_sequence<8>());
+  bench(std::make_index_sequence<32>());
+}
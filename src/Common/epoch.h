@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// 基于纪元（epoch）的内存回收，供读者不加锁、写时复制的结构（Chapter22 的
+// Signal、Chapter26 的 ConfigStore）回收被替换下来的旧版本。
+//
+// 进程内有一个全局纪元，每个线程有一条独占一个缓存行的记录。读者进入读临界区
+// 时把当前纪元写入自己的记录，离开时清零，读者之间不共享任何可写的数据，
+// 也没有读-改-写操作。写者替换共享指针之后推进纪元，旧对象以推进前的纪元 e
+// 退休；此后读到共享指针的读者记录的纪元都大于 e，因此所有活跃记录的纪元都
+// 大于 e 时，旧对象不再被任何读者持有，可以释放。
+//
+// 读临界区可以嵌套（比如在 Signal 的回调中再次 emit），只有最外层生效。
+// 长时间停在读临界区的线程只推迟它进入之后退休的对象，持续重叠的短读取
+// 不会阻止回收。
+class Epoch {
+  struct alignas(64) Record {
+    std::atomic<std::uint64_t> epoch{0}; // 0 表示不在读临界区
+    std::atomic<bool> inUse{true};
+    unsigned nesting = 0; // 只由持有记录的线程访问
+    Record *next = nullptr;
+  };
+
+  static inline std::atomic<std::uint64_t> global{1};
+  static inline std::atomic<Record *> records{nullptr};
+
+  // 线程第一次读取时取得一条记录（优先复用已退出线程的记录），线程结束时
+  // 归还。记录链表只增不减，扫描时不需要同步。
+  static Record *acquire() {
+    for (Record *r = records.load(std::memory_order_acquire); r; r = r->next) {
+      bool expected = false;
+      if (!r->inUse.load(std::memory_order_relaxed) &&
+          r->inUse.compare_exchange_strong(expected, true)) {
+        return r;
+      }
+    }
+    Record *r = new Record;
+    r->next = records.load(std::memory_order_relaxed);
+    while (!records.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+    return r;
+  }
+
+  struct Owner {
+    Record *record = acquire();
+    ~Owner() { record->inUse.store(false, std::memory_order_release); }
+  };
+
+  static Record &self() {
+    static thread_local Owner owner;
+    return *owner.record;
+  }
+
+public:
+  // 进入和离开读临界区。记录纪元和之后读取共享指针都是 seq_cst，
+  // 写者扫描记录时要么看到这次进入，要么这次读取一定能看到新指针。
+  static void enter() {
+    Record &r = self();
+    if (r.nesting++ == 0) {
+      r.epoch.store(global.load());
+    }
+  }
+  static void leave() {
+    Record &r = self();
+    if (--r.nesting == 0) {
+      r.epoch.store(0, std::memory_order_release);
+    }
+  }
+
+  // 写者替换共享指针之后调用，返回旧对象的退休纪元
+  static std::uint64_t advance() { return global.fetch_add(1); }
+
+  // 活跃读者记录中最小的纪元，没有活跃读者时为最大值
+  static std::uint64_t oldestActive() {
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (Record *r = records.load(std::memory_order_acquire); r; r = r->next) {
+      if (std::uint64_t e = r->epoch.load(); e != 0) {
+        oldest = std::min(oldest, e);
+      }
+    }
+    return oldest;
+  }
+};
+
+// 读临界区的作用域守卫，只能在创建它的线程中析构
+class EpochGuard {
+public:
+  EpochGuard() { Epoch::enter(); }
+  EpochGuard(EpochGuard const &) = delete;
+  EpochGuard &operator=(EpochGuard const &) = delete;
+  ~EpochGuard() { Epoch::leave(); }
+};
+
+// 等待回收的旧对象，只由写者在自己的锁内访问
+template <typename T> class RetireList {
+  std::vector<std::pair<T const *, std::uint64_t>> items;
+
+public:
+  RetireList() = default;
+  RetireList(RetireList const &) = delete;
+  RetireList &operator=(RetireList const &) = delete;
+  // 析构时不能有读者仍在使用这些对象
+  ~RetireList() {
+    for (auto const &item : items) {
+      delete item.first;
+    }
+  }
+
+  // old 已经从共享指针上摘下：推进纪元后放入列表，并回收已经安全的对象
+  void retire(T const *old) {
+    items.emplace_back(old, Epoch::advance());
+    reclaim();
+  }
+
+  void reclaim() {
+    std::uint64_t oldest = Epoch::oldestActive();
+    std::erase_if(items, [oldest](auto const &item) {
+      if (item.second < oldest) {
+        delete item.first;
+        return true;
+      }
+      return false;
+    });
+  }
+
+  std::size_t size() const { return items.size(); }
+};
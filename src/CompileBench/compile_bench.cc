@@ -0,0 +1,158 @@
+// 元编程组件的编译期基准
+// 逐个编译用例表中的合成输入（-fsyntax-only），记录墙钟时间、编译器的峰值
+// 内存，以及在 GCC 下由 -fdump-lang-class 统计的实例化的类的个数，结果写成
+// CSV。用例表由 CMake 生成，每行以制表符分隔：
+//   组件  操作  规模  源文件  额外的编译选项（空格分隔）
+// 用法：compile_bench <编译器> <用例表> <CSV 输出> [--gnu-dumps]
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Case {
+  std::string component;
+  std::string operation;
+  std::string size;
+  std::string source;
+  std::vector<std::string> flags;
+};
+
+struct Measurement {
+  double seconds = 0;
+  long peakKilobytes = 0; // ru_maxrss，Linux 下单位为 KB
+  long instantiations = -1;
+  bool ok = false;
+};
+
+std::vector<Case> readCases(std::string const &path) {
+  std::vector<Case> cases;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    Case c;
+    std::string flags;
+    std::getline(fields, c.component, '\t');
+    std::getline(fields, c.operation, '\t');
+    std::getline(fields, c.size, '\t');
+    std::getline(fields, c.source, '\t');
+    std::getline(fields, flags);
+    std::istringstream words(flags);
+    for (std::string flag; words >> flag;) {
+      c.flags.push_back(flag);
+    }
+    cases.push_back(std::move(c));
+  }
+  return cases;
+}
+
+// 统计并删除以 prefix 开头的 .class 转储中以 "Class " 开头的行
+long countInstantiations(std::filesystem::path const &prefix) {
+  long count = 0;
+  std::string stem = prefix.filename().string();
+  for (auto const &entry :
+       std::filesystem::directory_iterator(prefix.parent_path())) {
+    std::string name = entry.path().filename().string();
+    if (name.compare(0, stem.size(), stem) != 0 ||
+        entry.path().extension() != ".class") {
+      continue;
+    }
+    std::ifstream dump(entry.path());
+    for (std::string line; std::getline(dump, line);) {
+      count += line.compare(0, 6, "Class ") == 0;
+    }
+    dump.close();
+    std::filesystem::remove(entry.path());
+  }
+  return count;
+}
+
+Measurement run(std::string const &compiler, Case const &c,
+                std::filesystem::path const &dumpPrefix, bool gnuDumps) {
+  std::vector<std::string> args = {compiler,       "-std=c++20",
+                                   "-fsyntax-only", "-ftemplate-depth=2048",
+                                   "-DSIZE=" + c.size};
+  args.insert(args.end(), c.flags.begin(), c.flags.end());
+  if (gnuDumps) {
+    args.insert(args.end(),
+                {"-fdump-lang-class", "-dumpbase", dumpPrefix.string()});
+  }
+  args.push_back(c.source);
+  std::vector<char *> argv;
+  for (auto &arg : args) {
+    argv.push_back(arg.data());
+  }
+  argv.push_back(nullptr);
+
+  Measurement m;
+  auto start = std::chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid == 0) {
+    execvp(argv[0], argv.data());
+    std::perror("execvp");
+    _exit(127);
+  }
+  if (pid < 0) {
+    std::perror("fork");
+    return m;
+  }
+  int status = 0;
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+  auto end = std::chrono::steady_clock::now();
+
+  m.seconds = std::chrono::duration<double>(end - start).count();
+  m.peakKilobytes = usage.ru_maxrss;
+  m.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  if (gnuDumps) {
+    long count = countInstantiations(dumpPrefix);
+    m.instantiations = m.ok ? count : -1;
+  }
+  return m;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0]
+              << " <compiler> <cases> <csv> [--gnu-dumps]\n";
+    return 2;
+  }
+  std::string compiler = argv[1];
+  std::vector<Case> cases = readCases(argv[2]);
+  std::filesystem::path csvPath = argv[3];
+  bool gnuDumps = argc > 4 && std::string(argv[4]) == "--gnu-dumps";
+  std::filesystem::path dumpPrefix =
+      std::filesystem::absolute(csvPath).parent_path() / "compile_bench_dump";
+
+  std::ofstream csv(csvPath);
+  csv << "component,operation,size,seconds,peak_kb,instantiations,status\n";
+  bool allOk = true;
+  for (Case const &c : cases) {
+    Measurement m = run(compiler, c, dumpPrefix, gnuDumps);
+    allOk = allOk && m.ok;
+    char seconds[32];
+    std::snprintf(seconds, sizeof seconds, "%.3f", m.seconds);
+    std::ostringstream row;
+    row << c.component << ',' << c.operation << ',' << c.size << ','
+        << seconds << ',' << m.peakKilobytes << ',';
+    if (m.instantiations >= 0) {
+      row << m.instantiations;
+    }
+    row << ',' << (m.ok ? "ok" : "failed");
+    csv << row.str() << '\n' << std::flush;
+    std::cout << row.str() << std::endl;
+  }
+  std::cout << "written to " << csvPath.string() << '\n';
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "coroutine.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// C++20 协程：Task<T>、whenAll 与两种调度器，见 coroutine.h
+
+Task<int> answer() { co_return 42; }
+
+// 深度递归的 await 链：蹦床保证不会因为链长而栈溢出，与优化级别无关
+Task<long> chain(long depth) {
+  if (depth == 0) {
+    co_return 0;
+  }
+  co_return co_await chain(depth - 1) + 1;
+}
+
+Task<std::string> greet(SingleThreadScheduler &scheduler, std::string name) {
+  co_await scheduler.schedule(); // 让出执行权，其他任务可以先运行
+  co_return "hello, " + name;
+}
+
+Task<void> fail() {
+  throw std::runtime_error("task failed");
+  co_return;
+}
+
+Task<void> test1(SingleThreadScheduler &scheduler) {
+  std::cout << "answer: " << co_await answer() << std::endl;
+  std::cout << "chain: " << co_await chain(1000000) << std::endl;
+
+  auto [a, b, c] = co_await whenAll(greet(scheduler, "a"),
+                                    greet(scheduler, "b"), answer());
+  std::cout << a << ", " << b << ", " << c << std::endl;
+
+  try {
+    co_await whenAll(answer(), fail());
+  } catch (std::exception const &e) {
+    std::cout << "whenAll rethrows: " << e.what() << std::endl;
+  }
+}
+
+// 在多线程调度器上并行计算
+Task<long> partialSum(ThreadPoolScheduler &pool, long begin, long end) {
+  co_await pool.schedule(); // 切换到工作线程
+  long sum = 0;
+  for (long i = begin; i != end; ++i) {
+    sum += i;
+  }
+  co_return sum;
+}
+
+Task<long> test2(ThreadPoolScheduler &pool) {
+  auto [s1, s2, s3, s4] = co_await whenAll(
+      partialSum(pool, 0, 250000), partialSum(pool, 250000, 500000),
+      partialSum(pool, 500000, 750000), partialSum(pool, 750000, 1000000));
+  co_return s1 + s2 + s3 + s4;
+}
+
+Task<void> noop() { co_return; }
+
+int main() {
+  SingleThreadScheduler scheduler;
+  scheduler.blockOn(test1(scheduler));
+
+  ThreadPoolScheduler pool(4);
+  std::cout << "parallel sum: " << pool.blockOn(test2(pool)) << std::endl;
+
+  // 帧池：稳定后创建和销毁任务不再访问全局堆
+  std::size_t before = FramePool::heapAllocationCount();
+  for (int i = 0; i != 100000; ++i) {
+    scheduler.blockOn(noop());
+  }
+  std::cout << "frames from heap for 100000 tasks: "
+            << FramePool::heapAllocationCount() - before << std::endl;
+}
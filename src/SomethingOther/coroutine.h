@@ -0,0 +1,552 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// 基于 C++20 协程的 Task<T>
+// - Task 是惰性的：创建时不执行，被 co_await 或交给调度器时才开始。
+// - co_await 子任务和子任务结束时都不在 await_suspend 中直接恢复下一个协程，
+//   而是交给当前线程的蹦床（Trampoline）：当前协程挂起、resume() 返回之后，
+//   由蹦床的循环恢复下一个。任意深的 await 链都不会增加栈深度，也不依赖
+//   编译器把对称转移实现为尾调用（GCC 只在开启优化时这样做）。
+// - 协程帧从按大小分级的线程局部空闲链表中分配，释放的帧留给下一个协程复用，
+//   稳定运行时每次挂起、每个新任务都不需要访问全局堆。
+
+// 协程帧池：按 64 字节分级，超过 MaxPooled 的帧直接使用全局堆
+class FramePool {
+  static constexpr std::size_t Granularity = 64;
+  static constexpr std::size_t MaxPooled = 2048;
+  static constexpr std::size_t Classes = MaxPooled / Granularity;
+  static constexpr std::size_t MaxCached = 256; // 每级最多缓存的空闲帧
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  struct Lists {
+    std::array<FreeBlock *, Classes> heads{};
+    std::array<std::size_t, Classes> counts{};
+    ~Lists() {
+      for (FreeBlock *head : heads) {
+        while (head) {
+          FreeBlock *next = head->next;
+          ::operator delete(head);
+          head = next;
+        }
+      }
+    }
+  };
+
+  static Lists &lists() {
+    static thread_local Lists instance;
+    return instance;
+  }
+
+  static std::size_t classOf(std::size_t size) {
+    return (size + Granularity - 1) / Granularity - 1;
+  }
+
+  static inline std::atomic<std::size_t> heapAllocations{0};
+
+public:
+  static void *allocate(std::size_t size) {
+    if (size <= MaxPooled) {
+      Lists &l = lists();
+      std::size_t c = classOf(size);
+      if (FreeBlock *block = l.heads[c]) {
+        l.heads[c] = block->next;
+        --l.counts[c];
+        return block;
+      }
+      size = (c + 1) * Granularity;
+    }
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+
+  // 帧可能在另一个线程上释放，这时它进入释放线程的空闲链表
+  static void deallocate(void *p, std::size_t size) {
+    if (size <= MaxPooled) {
+      Lists &l = lists();
+      std::size_t c = classOf(size);
+      if (l.counts[c] < MaxCached) {
+        l.heads[c] = new (p) FreeBlock{l.heads[c]};
+        ++l.counts[c];
+        return;
+      }
+    }
+    ::operator delete(p);
+  }
+
+  // 从全局堆分配的帧数，用于观察帧的复用情况
+  static std::size_t heapAllocationCount() { return heapAllocations.load(); }
+};
+
+// 所有协程的 promise 都从这里继承帧的分配方式
+struct PooledPromise {
+  static void *operator new(std::size_t size) {
+    return FramePool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size) {
+    FramePool::deallocate(p, size);
+  }
+};
+
+template <typename T = void> class Task;
+
+// whenAll 和 blockOn 保存结果的类型，void 对应 std::monostate
+template <typename T>
+using WhenAllValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+namespace detail {
+
+// 每个线程一个蹦床。run(h) 循环地恢复协程：被恢复的协程挂起前用 transfer()
+// 登记下一个要恢复的协程，resume() 返回后循环再恢复它，栈深度不随转移的
+// 次数增长。调度器和组合子恢复协程时都使用 run()；在蹦床之外（比如用户
+// 直接调用 resume()）的 transfer() 会就地开始一个新的循环。
+class Trampoline {
+  struct State {
+    bool running = false;
+    std::coroutine_handle<> next;
+  };
+  static State &state() {
+    static thread_local State instance;
+    return instance;
+  }
+
+public:
+  static void run(std::coroutine_handle<> h) {
+    State &s = state();
+    bool outer = std::exchange(s.running, true);
+    auto saved = std::exchange(s.next, {});
+    while (h) {
+      h.resume();
+      h = std::exchange(s.next, {});
+    }
+    s.running = outer;
+    s.next = saved;
+  }
+
+  // 在 await_suspend 中调用，之后不能再访问当前协程
+  static void transfer(std::coroutine_handle<> h) {
+    State &s = state();
+    if (s.running) {
+      s.next = h;
+    } else {
+      run(h);
+    }
+  }
+};
+
+// 协程结束时恢复等待它的协程，没有时返回到恢复者
+struct FinalAwaiter {
+  bool await_ready() const noexcept { return false; }
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> h) const noexcept {
+    if (auto continuation = h.promise().continuation) {
+      Trampoline::transfer(continuation);
+    }
+  }
+  void await_resume() const noexcept {}
+};
+
+struct TaskPromiseBase : PooledPromise {
+  std::coroutine_handle<> continuation;
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+};
+
+template <typename T> struct TaskPromise : TaskPromiseBase {
+  std::variant<std::monostate, T, std::exception_ptr> result;
+
+  Task<T> get_return_object();
+  template <typename U> void return_value(U &&value) {
+    result.template emplace<1>(std::forward<U>(value));
+  }
+  void unhandled_exception() {
+    result.template emplace<2>(std::current_exception());
+  }
+  T take() {
+    if (result.index() == 2) {
+      std::rethrow_exception(std::get<2>(result));
+    }
+    return std::move(std::get<1>(result));
+  }
+};
+
+template <> struct TaskPromise<void> : TaskPromiseBase {
+  std::exception_ptr error;
+
+  Task<void> get_return_object();
+  void return_void() {}
+  void unhandled_exception() { error = std::current_exception(); }
+  void take() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename T> class Task {
+public:
+  using promise_type = detail::TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+private:
+  Handle handle;
+
+public:
+  explicit Task(Handle h) : handle(h) {}
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle) {
+        handle.destroy();
+      }
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+  Task(Task const &) = delete;
+  Task &operator=(Task const &) = delete;
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  bool done() const { return handle.done(); }
+
+  // co_await task：记录等待者后转移到子任务
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      Handle handle;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        detail::Trampoline::transfer(handle);
+      }
+      T await_resume() { return handle.promise().take(); }
+    };
+    return Awaiter{handle};
+  }
+
+  // 供调度器和组合子使用
+  Handle release() { return std::exchange(handle, {}); }
+  Handle get() const { return handle; }
+};
+
+namespace detail {
+template <typename T> Task<T> TaskPromise<T>::get_return_object() {
+  return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+inline Task<void> TaskPromise<void>::get_return_object() {
+  return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+// 分离执行的驱动协程：结束时自行销毁帧
+struct Detached {
+  struct promise_type : PooledPromise {
+    Detached get_return_object() {
+      return Detached{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+  std::coroutine_handle<promise_type> handle;
+};
+
+// 运行 task 并保存结果，结束时调用 notify()；供各调度器的 blockOn 使用
+template <typename T> struct BlockState {
+  std::optional<WhenAllValue<T>> result;
+  std::exception_ptr error;
+
+  WhenAllValue<T> take() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return std::move(*result);
+  }
+};
+
+template <typename T, typename Notify>
+Detached runBlocking(Task<T> task, BlockState<T> &state, Notify notify) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      state.result.emplace();
+    } else {
+      state.result.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    state.error = std::current_exception();
+  }
+  notify();
+}
+
+inline Detached runDetached(Task<void> task) { co_await std::move(task); }
+
+} // namespace detail
+
+// when_all：并发等待所有子任务，结果按顺序放在 tuple 中（void 对应
+// std::monostate）。任何子任务抛出的异常在全部结束后重新抛出（第一个）。
+namespace detail {
+
+struct WhenAllState {
+  std::atomic<std::size_t> remaining;
+  std::coroutine_handle<> continuation;
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  // 最后一个结束的子任务负责恢复等待者
+  void arrive() {
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Trampoline::transfer(continuation);
+    }
+  }
+};
+
+struct WhenAllChild {
+  struct promise_type : PooledPromise {
+    WhenAllState *state = nullptr;
+    WhenAllChild get_return_object() {
+      return WhenAllChild{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    auto final_suspend() const noexcept {
+      struct Awaiter {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+          WhenAllState *state = h.promise().state;
+          h.destroy();
+          state->arrive();
+        }
+        void await_resume() const noexcept {}
+      };
+      return Awaiter{};
+    }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+WhenAllChild runWhenAllChild(Task<T> task, std::optional<WhenAllValue<T>> &slot,
+                             WhenAllState &state) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      slot.emplace();
+    } else {
+      slot.emplace(co_await std::move(task));
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(state.errorMutex);
+    if (!state.error) {
+      state.error = std::current_exception();
+    }
+  }
+}
+
+template <std::size_t N> struct WhenAllAwaiter {
+  WhenAllState &state;
+  std::array<WhenAllChild, N> children;
+
+  bool await_ready() const noexcept { return N == 0; }
+  bool await_suspend(std::coroutine_handle<> awaiting) {
+    state.continuation = awaiting;
+    state.remaining.store(children.size() + 1, std::memory_order_relaxed);
+    for (WhenAllChild &child : children) {
+      child.handle.promise().state = &state;
+      Trampoline::run(child.handle);
+    }
+    // 额外的一个计数防止子任务在启动过程中就恢复等待者
+    return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+  void await_resume() const noexcept {}
+};
+
+} // namespace detail
+
+template <typename... Ts>
+Task<std::tuple<WhenAllValue<Ts>...>> whenAll(Task<Ts>... tasks) {
+  detail::WhenAllState state;
+  std::tuple<std::optional<WhenAllValue<Ts>>...> slots;
+  co_await [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    return detail::WhenAllAwaiter<sizeof...(Ts)>{
+        state, {detail::runWhenAllChild(std::move(tasks),
+                                        std::get<Is>(slots), state)...}};
+  }(std::index_sequence_for<Ts...>());
+  if (state.error) {
+    std::rethrow_exception(state.error);
+  }
+  co_return std::apply(
+      [](auto &...slot) {
+        return std::tuple<WhenAllValue<Ts>...>(std::move(*slot)...);
+      },
+      slots);
+}
+
+// 单线程调度器：就绪协程的 FIFO 队列，由调用 run() 的线程依次恢复
+class SingleThreadScheduler {
+  std::deque<std::coroutine_handle<>> ready;
+
+public:
+  // co_await scheduler.schedule()：把当前协程放回队尾，让出执行权
+  auto schedule() {
+    struct Awaiter {
+      SingleThreadScheduler &scheduler;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) {
+        scheduler.ready.push_back(h);
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+  // 分离地运行一个任务，任务的异常会终止程序
+  void spawn(Task<void> task) {
+    ready.push_back(detail::runDetached(std::move(task)).handle);
+  }
+
+  bool runOne() {
+    if (ready.empty()) {
+      return false;
+    }
+    auto h = ready.front();
+    ready.pop_front();
+    detail::Trampoline::run(h);
+    return true;
+  }
+
+  void run() {
+    while (runOne()) {
+    }
+  }
+
+  // 运行调度器直到 task 结束，返回其结果
+  template <typename T> T blockOn(Task<T> task) {
+    detail::BlockState<T> state;
+    bool finished = false;
+    ready.push_back(detail::runBlocking(std::move(task), state,
+                                        [&finished] { finished = true; })
+                        .handle);
+    while (!finished && runOne()) {
+    }
+    if (!finished) {
+      throw std::logic_error("blockOn: task is suspended with nothing to run");
+    }
+    return static_cast<T>(state.take());
+  }
+};
+
+// 多线程调度器：固定数量的工作线程共享一个就绪队列
+class ThreadPoolScheduler {
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  std::deque<std::coroutine_handle<>> ready;
+  std::vector<std::thread> workers;
+  bool stopping = false;
+
+  void enqueue(std::coroutine_handle<> h) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ready.push_back(h);
+    }
+    wakeUp.notify_one();
+  }
+
+  void workerLoop() {
+    for (;;) {
+      std::coroutine_handle<> h;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeUp.wait(lock, [this] { return stopping || !ready.empty(); });
+        if (ready.empty()) {
+          return;
+        }
+        h = ready.front();
+        ready.pop_front();
+      }
+      detail::Trampoline::run(h);
+    }
+  }
+
+public:
+  explicit ThreadPoolScheduler(
+      std::size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+    for (std::size_t i = 0; i != threads; ++i) {
+      workers.emplace_back([this] { workerLoop(); });
+    }
+  }
+  ThreadPoolScheduler(ThreadPoolScheduler const &) = delete;
+  ThreadPoolScheduler &operator=(ThreadPoolScheduler const &) = delete;
+
+  // 执行完队列中的协程后退出；仍挂起在其他地方的协程不会被恢复
+  ~ThreadPoolScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  // co_await scheduler.schedule()：之后的代码在某个工作线程上继续
+  auto schedule() {
+    struct Awaiter {
+      ThreadPoolScheduler &scheduler;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) { scheduler.enqueue(h); }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+  void spawn(Task<void> task) {
+    enqueue(detail::runDetached(std::move(task)).handle);
+  }
+
+  // 在工作线程上运行 task，阻塞调用线程直到它结束
+  template <typename T> T blockOn(Task<T> task) {
+    detail::BlockState<T> state;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    bool finished = false;
+    enqueue(detail::runBlocking(std::move(task), state,
+                                [&] {
+                                  std::lock_guard<std::mutex> lock(doneMutex);
+                                  finished = true;
+                                  doneCv.notify_one();
+                                })
+                .handle);
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&] { return finished; });
+    return static_cast<T>(state.take());
+  }
+};
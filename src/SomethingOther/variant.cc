@@ -1,3 +1,5 @@
+#include "../Chapter26/config_store.h"
+#include "../Chapter26/state_machine.h"
 #include <array>
 #include <iostream>
 #include <optional>
@@ -5,14 +7,19 @@
 
 void test2();
 void test3();
+void test4();
+void test5();
 
 // std::variant & std::visit 的应用场景
 // 1. 配置管理：配置中可能包含多种选项，可以用 std::map<std::string,
 // std::variant<int, double, std::string>> 存储，并且使用 visit
 // 对不同的类型采取不同的处理方式。
+// 热路径上反复读取时可以使用 Chapter26/config_store.h：加载后冻结为完美哈希
+// 的扁平表，通过句柄读取，见 test5()。
 
 // 2. 状态机：使用枚举类型 + variant + visit
 // std::variant<IdleState, RunningState, ErrorState> currentState;
+// 见 Chapter26/state_machine.h 以及下面的 test4()。
 
 int main() {
   // 类似于 union
@@ -39,6 +46,8 @@ int main() {
 
   test2();
   test3();
+  test4();
+  test5();
 }
 
 template <class... Ts> struct overloaded : Ts... {
@@ -76,4 +85,105 @@ void test3() {
 
   std::cout << std::visit(cvisitor, x) << std::endl;
 
-}
\ No newline at end of file
+}
+
+// 状态机：状态是 Variant 的备选类型，事件是类型，转移表在编译期确定
+struct Start {
+  int jobId;
+};
+struct Fail {
+  int code;
+};
+struct Finish {};
+struct Reset {};
+
+struct Idle {};
+struct Running {
+  int jobId;
+  explicit Running(Start const &event) : jobId(event.jobId) {}
+};
+struct Error {
+  int jobId, code;
+  // 目标状态也可以同时使用旧状态和事件来构造
+  Error(Running const &from, Fail const &event)
+      : jobId(from.jobId), code(event.code) {}
+};
+
+using Machine = StateMachine<
+    Typelist<Idle, Running, Error>,
+    Typelist<Transition<Idle, Start, Running>, Transition<Running, Finish, Idle>,
+             Transition<Running, Fail, Error>, Transition<Error, Reset, Idle>>>;
+
+void test4() {
+  Machine machine;
+  auto print = [&machine] {
+    machine.visit([](auto const &state) {
+      using State = std::decay_t<decltype(state)>;
+      if constexpr (std::is_same_v<State, Idle>) {
+        printf("Idle.\n");
+      } else if constexpr (std::is_same_v<State, Running>) {
+        printf("Running job %d.\n", state.jobId);
+      } else {
+        printf("Job %d failed with %d.\n", state.jobId, state.code);
+      }
+    });
+  };
+
+  machine.process(Start{7});
+  print();
+  machine.process(Fail{42});
+  print();
+  std::cout << machine.process(Start{8}) << std::endl; // Error 不处理 Start
+  machine.process(Reset{});
+  print();
+}
+
+// 配置：加载后冻结，句柄读取只需一次下标访问
+void test5() {
+  using Config = ConfigStore<int, double, std::string>;
+  using Value = Config::Value;
+  Config config;
+  config.load({{"threads", Value(8)},
+               {"ratio", Value(0.75)},
+               {"name", Value(std::string("server"))}});
+
+  auto threads = config.handle<int>("threads");
+  auto name = config.handle<std::string>("name");
+  {
+    auto snapshot = config.read();
+    std::cout << snapshot.get(threads) << " " << snapshot.get(name)
+              << std::endl;
+  }
+
+  // 重新加载：句柄依然有效，读者无需加锁
+  config.load({{"threads", Value(16)},
+               {"name", Value(std::string("server-2"))},
+               {"timeout", Value(1.5)}});
+  {
+    auto snapshot = config.read();
+    std::cout << snapshot.get(threads) << " " << snapshot.get(name) << " "
+              << *snapshot.find<double>("timeout") << " "
+              << !snapshot.find<double>("ratio") << std::endl;
+  }
+
+  // 快照存在期间，引用在重新加载后仍然有效
+  {
+    auto snapshot = config.read();
+    std::string const &before = snapshot.get(name);
+    config.load({{"threads", Value(16)},
+                 {"name", Value(std::string("server-3"))}});
+    std::cout << before << " " << config.read().get(name) << std::endl;
+  }
+
+  // ratio 在上一次加载中缺失，但类型仍然固定为 double；被拒绝的加载
+  // 不改变 store，之后 extra 仍然可以以 double 首次出现
+  try {
+    config.load({{"extra", Value(1)}, {"ratio", Value(std::string("high"))}});
+  } catch (std::invalid_argument const &e) {
+    std::cout << e.what() << std::endl;
+  }
+  config.load({{"extra", Value(2.5)}, {"ratio", Value(0.5)}});
+  auto snapshot = config.read();
+  std::cout << *snapshot.find<double>("extra") << " "
+            << *snapshot.find<double>("ratio") << std::endl;
+}